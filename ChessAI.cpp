@@ -23,16 +23,39 @@ const int ChessAI::QUEEN_PST[64];
 const int ChessAI::KING_PST[64];
 
 
-ChessAI::ChessAI() : move_gen() {
+ChessAI::ChessAI() :
+    ChessAI(std::make_shared<TranspositionTable>(), std::make_shared<std::atomic<bool>>(false), 0) {
+    transposition_table->resize(TT_DEFAULT_SIZE_MB);
+}
+
+ChessAI::ChessAI(std::shared_ptr<TranspositionTable> shared_table, std::shared_ptr<std::atomic<bool>> shared_stop, int index) :
+    move_gen(),
+    transposition_table(std::move(shared_table)),
+    stop_search(std::move(shared_stop)),
+    ponder_move({0,0}, {0,0}, PieceTypeIndex::NONE),
+    uci_output(nullptr),
+    thread_count(NUMBER_OF_CORES_USED),
+    thread_index(index),
+    thread_pool(nullptr),
+    completed_depth(0),
+    completed_score(0),
+    completed_best_move({0,0}, {0,0}, PieceTypeIndex::NONE) {
     nodes_evaluated_count = 0;
     branches_explored_count = 0;
     current_search_depth_set = 0;
-    transposition_table.resize(ChessAI::TT_SIZE);
-    for (size_t i = 0; i < ChessAI::TT_SIZE; ++i) {
-        transposition_table[i].hash = 0;
+    search_stack.resize(MAX_PLY + 1);
+    history_scores_storage.resize(2 * 64 * 64, 0);
+    capture_history_storage.resize(12 * 64 * 6, 0);
+    continuation_history_storage.resize(12 * 64);
+    countermove_moves_storage.resize(12 * 64, Move({0,0}, {0,0}, PieceTypeIndex::NONE));
+    for (auto& table : continuation_history_storage) {
+        for (auto& row : table) {
+            row.fill(0);
+        }
     }
-    killer_moves_storage.resize(MAX_PLY * 2, Move({0,0}, {0,0}, PieceTypeIndex::NONE));
-    history_scores_storage.resize(64 * 64, 0);
+    pv_table_storage.resize(MAX_PLY * MAX_PLY, Move({0,0}, {0,0}, PieceTypeIndex::NONE));
+    pv_length_storage.resize(MAX_PLY + 1, 0);
+    eval_cache_storage.resize(EVAL_CACHE_ENTRIES, EvalCacheEntry{ 0ULL, EVAL_NONE });
 }
 
 // PIECE_SORT_VALUES remains local to ChessAI.cpp for move ordering heuristics
@@ -45,56 +68,251 @@ static constexpr int PIECE_SORT_VALUES[] = {
     0    // KING (PieceTypeIndex::KING = 5)
 };
 
+// Natural logarithm usable in constant expressions (std::log is not constexpr).
+// The argument is halved down into [1, 2] and the atanh series finishes the job.
+static constexpr double constexpr_ln(double x) {
+    constexpr double LN_2 = 0.69314718055994530942;
+    double result = 0.0;
+    while (x > 2.0) {
+        x /= 2.0;
+        result += LN_2;
+    }
+    double y = (x - 1.0) / (x + 1.0);
+    double y_squared = y * y;
+    double term = y;
+    for (int k = 1; k < 40; k += 2) {
+        result += 2.0 * term / k;
+        term *= y_squared;
+    }
+    return result;
+}
+
+static constexpr int LMR_MAX_MOVE_NUMBER = 64;
+
+// LMR_TABLE[depth][move_number]: base reduction in plies for a late quiet move.
+static constexpr std::array<std::array<int, LMR_MAX_MOVE_NUMBER>, ChessAI::MAX_PLY> build_lmr_table() {
+    std::array<std::array<int, LMR_MAX_MOVE_NUMBER>, ChessAI::MAX_PLY> table{};
+    for (int depth = 1; depth < ChessAI::MAX_PLY; ++depth) {
+        for (int move_number = 1; move_number < LMR_MAX_MOVE_NUMBER; ++move_number) {
+            table[depth][move_number] = static_cast<int>(LMR_BASE + constexpr_ln(depth) * constexpr_ln(move_number) / LMR_DIVISOR);
+        }
+    }
+    return table;
+}
+static constexpr auto LMR_TABLE = build_lmr_table();
+
+// Piece values used by static exchange evaluation. The king is priced so that
+// capturing with it into a defended square is never worth it.
+static constexpr int SEE_PIECE_VALUES[] = {
+    PAWN_VALUE, KNIGHT_VALUE, BISHOP_VALUE, ROOK_VALUE, QUEEN_VALUE, KING_VALUE, 0
+};
+
+// Static exchange evaluation: the material balance (from the mover's point of view) of the
+// sequence of captures on the move's destination square, with each side always recapturing
+// with its least valuable attacker and free to stop when continuing would lose material.
+static int static_exchange_eval(const ChessBoard& board, const Move& move) {
+    int from_sq = ChessBitboardUtils::rank_file_to_square(move.from_square.y, move.from_square.x);
+    int to_sq = ChessBitboardUtils::rank_file_to_square(move.to_square.y, move.to_square.x);
+
+    int gain[32];
+    int d = 0;
+    gain[0] = SEE_PIECE_VALUES[static_cast<int>(move.piece_captured_type_idx)];
+
+    PieceTypeIndex piece_on_square = move.piece_moved_type_idx;
+    if (move.is_promotion) {
+        gain[0] += SEE_PIECE_VALUES[static_cast<int>(move.promotion_piece_type_idx)] - PAWN_VALUE;
+        piece_on_square = move.promotion_piece_type_idx;
+    }
+
+    uint64_t occupancy = board.occupied_squares;
+    if (move.is_en_passant) {
+        int captured_sq = (board.active_player == PlayerColor::White) ? to_sq - 8 : to_sq + 8;
+        ChessBitboardUtils::clear_bit(occupancy, captured_sq);
+    }
+    uint64_t from_set = 1ULL << from_sq;
+
+    const uint64_t white_pieces[6] = { board.white_pawns, board.white_knights, board.white_bishops,
+                                       board.white_rooks, board.white_queens, board.white_king };
+    const uint64_t black_pieces[6] = { board.black_pawns, board.black_knights, board.black_bishops,
+                                       board.black_rooks, board.black_queens, board.black_king };
+
+    uint64_t attackers = board.attackers_to(to_sq, occupancy);
+    PlayerColor side = board.active_player;
+
+    do {
+        d++;
+        gain[d] = SEE_PIECE_VALUES[static_cast<int>(piece_on_square)] - gain[d - 1];
+        if (std::max(-gain[d - 1], gain[d]) < 0) {
+            break;
+        }
+
+        occupancy ^= from_set;
+        // Removing a piece may uncover a slider behind it (x-ray).
+        attackers = board.attackers_to(to_sq, occupancy) & occupancy;
+        side = (side == PlayerColor::White) ? PlayerColor::Black : PlayerColor::White;
+
+        from_set = 0ULL;
+        const uint64_t* side_pieces = (side == PlayerColor::White) ? white_pieces : black_pieces;
+        for (int piece = 0; piece < 6; ++piece) {
+            uint64_t candidates = attackers & side_pieces[piece];
+            if (candidates) {
+                from_set = candidates & (~candidates + 1); // Isolate one attacker.
+                piece_on_square = static_cast<PieceTypeIndex>(piece);
+                break;
+            }
+        }
+    } while (from_set && d < 31);
+
+    while (--d) {
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    }
+    return gain[0];
+}
+
+// Two moves are the same if they move the same piece between the same squares
+// and promote to the same piece.
+static bool same_move(const Move& a, const Move& b) {
+    return a.from_square.x == b.from_square.x &&
+           a.from_square.y == b.from_square.y &&
+           a.to_square.x == b.to_square.x &&
+           a.to_square.y == b.to_square.y &&
+           a.piece_moved_type_idx == b.piece_moved_type_idx &&
+           a.promotion_piece_type_idx == b.promotion_piece_type_idx;
+}
+
+// Mate scores are stored in the TT as distances from the node they belong to, not from the
+// root, so an entry stays correct when the position is reached again at a different ply.
+static int score_to_tt(int score, int ply) {
+    if (score >= ChessAI::MATE_IN_MAX_PLY) return score + ply;
+    if (score <= -ChessAI::MATE_IN_MAX_PLY) return score - ply;
+    return score;
+}
+
+static int score_from_tt(int score, int ply) {
+    if (score >= ChessAI::MATE_IN_MAX_PLY) return score - ply;
+    if (score <= -ChessAI::MATE_IN_MAX_PLY) return score + ply;
+    return score;
+}
+
+
+int ChessAI::static_evaluation(const ChessBoard& board) {
+    bool is_exact = true;
+    return static_evaluation(board, -MATE_VALUE, MATE_VALUE, is_exact);
+}
+
+int ChessAI::static_evaluation(const ChessBoard& board, int alpha, int beta, bool& is_exact) {
+    bool white_to_move = (board.active_player == PlayerColor::White);
+    EvalCacheEntry& entry = eval_cache_storage[board.zobrist_hash & (EVAL_CACHE_ENTRIES - 1)];
+    if (entry.key == board.zobrist_hash && entry.eval != EVAL_NONE) {
+        is_exact = true;
+        return white_to_move ? entry.eval : -entry.eval;
+    }
+
+    // The evaluation works from White's point of view, so Black's window is mirrored.
+    int white_eval = white_to_move ? Evaluation::evaluate(board, alpha, beta, is_exact)
+                                   : Evaluation::evaluate(board, -beta, -alpha, is_exact);
+    if (is_exact) {
+        entry.key = board.zobrist_hash;
+        entry.eval = white_eval;
+    }
+    return white_to_move ? white_eval : -white_eval;
+}
+
+void ChessAI::prefetch_eval_cache(uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(&eval_cache_storage[key & (EVAL_CACHE_ENTRIES - 1)]);
+#else
+    (void)key;
+#endif
+}
 
-int ChessAI::quiescence_search_internal(ChessBoard& board_ref, int alpha, int beta) {
+int ChessAI::quiescence_search_internal(ChessBoard& board_ref, int alpha, int beta, int ply, int qsearch_depth) {
     nodes_evaluated_count++;
 
-    uint64_t current_hash = board_ref.zobrist_hash;
-    size_t tt_index = current_hash % ChessAI::TT_SIZE;
-    TTEntry& entry = transposition_table[tt_index];
+    // Captures and evasions can run past MAX_PLY. The line stops there, so that no mate score
+    // from beyond MATE_IN_MAX_PLY reaches the TT, where it could not be told from a normal score.
+    if (ply >= MAX_PLY) {
+        return board_ref.is_king_in_check(board_ref.active_player) ? 0 : static_evaluation(board_ref);
+    }
 
-    if (entry.hash == current_hash) {
-        if (entry.depth >= 0) {
-            if (entry.flag == NodeType::EXACT) {
-                return entry.score;
+    uint64_t current_hash = board_ref.zobrist_hash;
+    bool tt_hit = false;
+    TTData tt_data;
+    TTEntry* tt_entry = transposition_table->probe(current_hash, tt_hit, tt_data);
+
+    if (tt_hit) {
+        int tt_score = score_from_tt(tt_data.score(), ply);
+        if (tt_data.depth() >= 0) {
+            if (tt_data.bound() == NodeType::EXACT) {
+                return tt_score;
             }
-            if (entry.flag == NodeType::LOWER_BOUND && entry.score >= beta) {
+            if (tt_data.bound() == NodeType::LOWER_BOUND && tt_score >= beta) {
                 return beta;
             }
-            if (entry.flag == NodeType::UPPER_BOUND && entry.score <= alpha) {
+            if (tt_data.bound() == NodeType::UPPER_BOUND && tt_score <= alpha) {
                 return alpha;
             }
         }
     }
 
-    // Call the new Evaluation::evaluate function
-    int stand_pat = (board_ref.active_player == PlayerColor::White) ? Evaluation::evaluate(board_ref) : -Evaluation::evaluate(board_ref);
+    int original_alpha = alpha;
+    PlayerColor us = board_ref.active_player;
+    bool in_check = board_ref.is_king_in_check(us);
+
+    // In check there is no stand-pat: standing still is not an option, so every evasion
+    // is searched and having none is checkmate.
+    int stand_pat = -ChessAI::MATE_VALUE + ply;
+    int static_eval = EVAL_NONE;
+    if (!in_check) {
+        // The TT keeps the static eval of every position it stores, so a hit saves the evaluation.
+        if (tt_hit && tt_data.eval() != EVAL_NONE) {
+            static_eval = tt_data.eval();
+            stand_pat = static_eval;
+        } else {
+            // Stand-pat only needs to know where the eval lies relative to the window, so the
+            // evaluation may stop early. A bound must not be stored as the static eval.
+            bool eval_is_exact = true;
+            stand_pat = static_evaluation(board_ref, alpha, beta, eval_is_exact);
+            if (eval_is_exact) {
+                static_eval = stand_pat;
+            }
+        }
 
-    if (stand_pat >= beta) {
-        TTEntry new_entry;
-        new_entry.hash = current_hash;
-        new_entry.score = beta;
-        new_entry.depth = 0;
-        new_entry.flag = NodeType::LOWER_BOUND;
-        transposition_table[tt_index] = new_entry;
-        return beta;
-    }
-    if (stand_pat > alpha) {
-        alpha = stand_pat;
+        if (stand_pat >= beta) {
+            tt_entry->save(current_hash, score_to_tt(beta, ply), static_eval, NodeType::LOWER_BOUND, 0, 0,
+                           transposition_table->generation());
+            return beta;
+        }
+        if (stand_pat > alpha) {
+            alpha = stand_pat;
+        }
     }
 
-    std::vector<Move> legal_moves = move_gen.generate_legal_moves(board_ref);
-
+    std::vector<Move> pseudo_legal_moves = move_gen.generate_pseudo_legal_moves(board_ref);
     std::vector<Move> noisy_moves;
-    noisy_moves.reserve(legal_moves.size());
+    noisy_moves.reserve(pseudo_legal_moves.size());
+    std::vector<Move> quiet_moves;
 
-    for (const auto& move : legal_moves) {
+    for (const auto& move : pseudo_legal_moves) {
         if (move.piece_captured_type_idx != PieceTypeIndex::NONE) {
             noisy_moves.push_back(move);
         }
         else if (move.promotion_piece_type_idx != PieceTypeIndex::NONE) {
             noisy_moves.push_back(move);
         }
+        else if (in_check) {
+            quiet_moves.push_back(move);
+        }
+        else if (QSEARCH_QUIET_CHECKS && qsearch_depth == 0) {
+            // Quiet checks are only tried on the first quiescence ply, so check sequences stay short.
+            StateInfo info_for_undo;
+            board_ref.apply_move(move, info_for_undo);
+            bool gives_check = !board_ref.is_king_in_check(us) && board_ref.is_king_in_check(board_ref.active_player);
+            board_ref.undo_move(move, info_for_undo);
+            if (gives_check && static_exchange_eval(board_ref, move) >= 0) {
+                quiet_moves.push_back(move);
+            }
+        }
     }
 
     std::sort(noisy_moves.begin(), noisy_moves.end(), [&](const Move& a, const Move& b) {
@@ -117,37 +335,57 @@ int ChessAI::quiescence_search_internal(ChessBoard& board_ref, int alpha, int be
         
         return score_a > score_b;
     });
+    // Quiet evasions and checks are tried after the captures.
+    noisy_moves.insert(noisy_moves.end(), quiet_moves.begin(), quiet_moves.end());
 
     if (noisy_moves.empty()) {
-        TTEntry new_entry;
-        new_entry.hash = current_hash;
-        new_entry.score = stand_pat;
-        new_entry.depth = 0;
-        new_entry.flag = NodeType::EXACT;
-        transposition_table[tt_index] = new_entry;
+        // A lazily evaluated stand-pat that did not fail high is only an upper bound.
+        NodeType stand_pat_bound = (in_check || static_eval != EVAL_NONE) ? NodeType::EXACT : NodeType::UPPER_BOUND;
+        tt_entry->save(current_hash, score_to_tt(stand_pat, ply), static_eval, stand_pat_bound, 0, 0,
+                       transposition_table->generation());
         return stand_pat;
     }
 
+    int legal_moves_played = 0;
     Move best_q_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
 
     for (const auto& move : noisy_moves) {
-        branches_explored_count++;
+        if (!in_check && move.piece_captured_type_idx != PieceTypeIndex::NONE) {
+            // Delta pruning: even winning this material outright cannot lift us to alpha.
+            int material_gain = SEE_PIECE_VALUES[static_cast<int>(move.piece_captured_type_idx)];
+            if (move.is_promotion) {
+                material_gain += SEE_PIECE_VALUES[static_cast<int>(move.promotion_piece_type_idx)] - PAWN_VALUE;
+            }
+            if (stand_pat + material_gain + QSEARCH_DELTA_MARGIN <= alpha) {
+                continue;
+            }
+        }
+        if (!in_check && static_exchange_eval(board_ref, move) < 0) {
+            // Losing captures cannot improve on standing pat.
+            continue;
+        }
 
         StateInfo info_for_undo;
         board_ref.apply_move(move, info_for_undo);
+        transposition_table->prefetch(board_ref.zobrist_hash);
+        prefetch_eval_cache(board_ref.zobrist_hash);
+        if (board_ref.is_king_in_check(us)) {
+            board_ref.undo_move(move, info_for_undo);
+            continue;
+        }
+        legal_moves_played++;
+        branches_explored_count++;
 
-        int score = -quiescence_search_internal(board_ref, -beta, -alpha); 
+        int score = -quiescence_search_internal(board_ref, -beta, -alpha, ply + 1, qsearch_depth - 1);
         
         board_ref.undo_move(move, info_for_undo);
+        if (search_stopped()) {
+            return 0;
+        }
 
         if (score >= beta) {
-            TTEntry new_entry;
-            new_entry.hash = current_hash;
-            new_entry.score = beta;
-            new_entry.depth = 0;
-            new_entry.flag = NodeType::LOWER_BOUND;
-            new_entry.best_move = move;
-            transposition_table[tt_index] = new_entry;
+            tt_entry->save(current_hash, score_to_tt(beta, ply), static_eval, NodeType::LOWER_BOUND, 0,
+                           TranspositionTable::pack_move(move), transposition_table->generation());
             return beta;
         }
         if (score > alpha) {
@@ -156,122 +394,346 @@ int ChessAI::quiescence_search_internal(ChessBoard& board_ref, int alpha, int be
         }
     }
 
+    if (in_check && legal_moves_played == 0) {
+        // No evasion was legal: checkmate. stand_pat already holds the mate score.
+        return stand_pat;
+    }
+
     NodeType flag_to_store_q;
-    if (alpha <= stand_pat) {
+    if (alpha <= original_alpha) {
         flag_to_store_q = NodeType::UPPER_BOUND;
     } else {
         flag_to_store_q = NodeType::EXACT;
     }
 
-    TTEntry new_entry;
-    new_entry.hash = current_hash;
-    new_entry.score = alpha;
-    new_entry.depth = 0;
-    new_entry.flag = flag_to_store_q;
-    new_entry.best_move = best_q_move;
-    transposition_table[tt_index] = new_entry;
+    tt_entry->save(current_hash, score_to_tt(alpha, ply), static_eval, flag_to_store_q, 0,
+                   TranspositionTable::pack_move(best_q_move), transposition_table->generation());
 
     return alpha;
 }
 
+// Move ordering bands. Quiet moves are ordered by history, which stays well below the killers.
+static constexpr int ORDER_PV_MOVE      = 4000000;
+static constexpr int ORDER_TT_MOVE      = 3000000;
+static constexpr int ORDER_CAPTURE_BASE = 2000000;
+static constexpr int ORDER_KILLER_1     = 1000001;
+static constexpr int ORDER_KILLER_2     = 1000000;
+static constexpr int ORDER_COUNTERMOVE  = 900000;
+
+// Index of a piece of the given color in the 12-entry colored piece tables (White 0-5, Black 6-11).
+static int colored_piece_index(PlayerColor side, PieceTypeIndex type) {
+    return (side == PlayerColor::Black ? 6 : 0) + static_cast<int>(type);
+}
+
+static int move_from_index(const Move& move) {
+    return ChessBitboardUtils::rank_file_to_square(move.from_square.y, move.from_square.x);
+}
+
+static int move_to_index(const Move& move) {
+    return ChessBitboardUtils::rank_file_to_square(move.to_square.y, move.to_square.x);
+}
+
+static int history_bonus(int depth) {
+    return std::min(HISTORY_BONUS_SCALE * depth * depth, HISTORY_BONUS_MAX);
+}
+
+// History gravity: the bonus shrinks as the entry approaches the bound, keeping it within +-HISTORY_MAX.
+static void apply_history_bonus(int& entry, int bonus) {
+    bonus = std::clamp(bonus, -HISTORY_MAX, HISTORY_MAX);
+    entry += bonus - entry * std::abs(bonus) / HISTORY_MAX;
+}
+
+static int capture_history_index(PlayerColor side, const Move& move) {
+    return (colored_piece_index(side, move.piece_moved_type_idx) * 64 + move_to_index(move)) * 6 +
+           static_cast<int>(move.piece_captured_type_idx);
+}
+
+// Butterfly history plus the continuation histories of the moves one and two plies back.
+int ChessAI::quiet_history_score(PlayerColor side, const Move& move, int ply) const {
+    int piece = colored_piece_index(side, move.piece_moved_type_idx);
+    int to_sq_idx = move_to_index(move);
+    int score = history_scores_storage[(side == PlayerColor::Black ? 4096 : 0) + move_from_index(move) * 64 + to_sq_idx];
+    for (int back = 1; back <= 2 && back <= ply; ++back) {
+        const PieceToHistory* continuation = search_stack[ply - back].continuation_history;
+        if (continuation != nullptr) {
+            score += (*continuation)[piece][to_sq_idx];
+        }
+    }
+    return score;
+}
+
+void ChessAI::update_quiet_histories(PlayerColor side, const Move& move, int ply, int bonus) {
+    int piece = colored_piece_index(side, move.piece_moved_type_idx);
+    int to_sq_idx = move_to_index(move);
+    apply_history_bonus(history_scores_storage[(side == PlayerColor::Black ? 4096 : 0) + move_from_index(move) * 64 + to_sq_idx], bonus);
+    for (int back = 1; back <= 2 && back <= ply; ++back) {
+        PieceToHistory* continuation = search_stack[ply - back].continuation_history;
+        if (continuation != nullptr) {
+            apply_history_bonus((*continuation)[piece][to_sq_idx], bonus);
+        }
+    }
+}
+
+// Makes `move` followed by the child's line the PV of `ply`.
+void ChessAI::update_pv(int ply, const Move& move) {
+    pv_table_storage[ply * MAX_PLY + ply] = move;
+    int child_length = pv_length_storage[ply + 1];
+    for (int i = ply + 1; i < child_length; ++i) {
+        pv_table_storage[ply * MAX_PLY + i] = pv_table_storage[(ply + 1) * MAX_PLY + i];
+    }
+    pv_length_storage[ply] = std::max(child_length, ply + 1);
+}
+
+// Formats a side-to-move score for UCI: "cp <centipawns>" or "mate <moves>" (negative when mated).
+static std::string score_to_uci(int score) {
+    if (score > ChessAI::MATE_IN_MAX_PLY) {
+        return "mate " + std::to_string((ChessAI::MATE_VALUE - score + 1) / 2);
+    }
+    if (score < -ChessAI::MATE_IN_MAX_PLY) {
+        return "mate " + std::to_string(-(ChessAI::MATE_VALUE + score) / 2);
+    }
+    return "cp " + std::to_string(score);
+}
+
+int ChessAI::alphaBeta(ChessBoard& board, int depth, int alpha, int beta, int ply) {
+    SearchStack& ss = search_stack[ply];
+    pv_length_storage[ply] = ply;
+
+    // An aborted helper search unwinds without storing anything: its scores are meaningless.
+    if (search_stopped()) {
+        return 0;
+    }
 
-int ChessAI::alphaBeta(ChessBoard& board, int depth, int alpha, int beta) {
+    // Mate distance pruning: even mating right here cannot beat a shorter mate found elsewhere,
+    // and being mated here cannot be worse than a mate already conceded closer to the root.
+    alpha = std::max(alpha, -ChessAI::MATE_VALUE + ply);
+    beta = std::min(beta, ChessAI::MATE_VALUE - ply - 1);
+    if (alpha >= beta) {
+        return alpha;
+    }
     int original_alpha = alpha;
-    int current_ply = AI_SEARCH_DEPTH - depth;
+
+    // The previous iteration's PV is only worth following while every move from the root matched it.
+    ss.follows_pv = search_stack[ply - 1].follows_pv &&
+                    ply - 1 < static_cast<int>(principal_variation.size()) &&
+                    same_move(search_stack[ply - 1].current_move, principal_variation[ply - 1]);
+
+    // During a singular extension search the TT move of this node is excluded, so the
+    // TT entry describes a different search and must neither cut off nor be overwritten.
+    const Move excluded_move = ss.excluded_move;
+    bool has_excluded_move = excluded_move.piece_moved_type_idx != PieceTypeIndex::NONE;
 
     uint64_t current_hash = board.zobrist_hash;
-    size_t tt_index = current_hash % ChessAI::TT_SIZE;
-    TTEntry& entry = transposition_table[tt_index];
-
-    if (entry.hash == current_hash) {
-        int tt_score = entry.score;
-        if (std::abs(tt_score) > (ChessAI::MATE_VALUE - 1000)) {
-            if (tt_score > 0) {
-                tt_score -= (current_search_depth_set - depth);
-            } else {
-                tt_score += (current_search_depth_set - depth);
-            }
+    bool tt_hit = false;
+    TTEntry* tt_entry = nullptr;
+    int tt_score = 0;
+    int tt_depth = -1;
+    int tt_eval = EVAL_NONE;
+    NodeType tt_bound = NodeType::UPPER_BOUND;
+    uint16_t tt_move16 = 0;
+
+    // The entry is copied out because the searches below may reuse its slot for other positions.
+    auto read_tt_entry = [&]() {
+        TTData tt_data;
+        tt_entry = transposition_table->probe(current_hash, tt_hit, tt_data);
+        if (tt_hit) {
+            tt_score = score_from_tt(tt_data.score(), ply);
+            tt_depth = tt_data.depth();
+            tt_eval = tt_data.eval();
+            tt_bound = tt_data.bound();
+            tt_move16 = tt_data.move();
         }
+    };
+    read_tt_entry();
 
-        if (entry.depth >= depth) {
-            if (entry.flag == NodeType::EXACT) {
+    if (tt_hit && !has_excluded_move) {
+        if (tt_depth >= depth) {
+            if (tt_bound == NodeType::EXACT) {
                 return tt_score;
             }
-            if (entry.flag == NodeType::LOWER_BOUND && tt_score >= beta) {
+            if (tt_bound == NodeType::LOWER_BOUND && tt_score >= beta) {
                 return beta;
             }
-            if (entry.flag == NodeType::UPPER_BOUND && tt_score <= alpha) {
+            if (tt_bound == NodeType::UPPER_BOUND && tt_score <= alpha) {
                 return alpha;
             }
         }
     }
     
+    // Horizon nodes go straight to quiescence search, before any move generation.
+    if (depth <= 0 || ply >= MAX_PLY - 1) {
+        return quiescence_search_internal(board, alpha, beta, ply);
+    }
+
     nodes_evaluated_count++;
 
-    std::vector<Move> legal_moves = move_gen.generate_legal_moves(board);
+    // Pseudo-legal moves only: legality is checked right after each move is made, so moves
+    // that are pruned or never reached because of a cutoff are never tested at all.
+    std::vector<Move> pseudo_legal_moves = move_gen.generate_pseudo_legal_moves(board);
+
+    bool is_pv_node = (beta - alpha > 1);
+    PlayerColor us = board.active_player;
+    bool in_check = board.is_king_in_check(us);
+
+    // Static evaluation from the side to move's point of view. It drives all of the frontier
+    // pruning decisions below and is cached on the stack, so re-searches of this position at
+    // the same ply (PVS/LMR re-searches, IID, singular searches) do not evaluate it again.
+    int static_eval = EVAL_NONE;
+    if (!in_check) {
+        if (ss.static_eval_hash == current_hash && ss.static_eval != EVAL_NONE) {
+            static_eval = ss.static_eval;
+        } else if (tt_hit && tt_eval != EVAL_NONE) {
+            static_eval = tt_eval;
+        } else {
+            static_eval = static_evaluation(board);
+        }
+    }
+    ss.static_eval = static_eval;
+    ss.static_eval_hash = current_hash;
+
+    // The position is improving if our static eval went up since our previous move.
+    // Improving nodes are pruned less eagerly.
+    bool improving = !in_check;
+    if (!in_check && ply >= 2 && search_stack[ply - 2].static_eval != EVAL_NONE) {
+        improving = static_eval > search_stack[ply - 2].static_eval;
+    }
 
-    if (depth == 0) {
-        return quiescence_search_internal(board, alpha, beta);
+    // Internal iterative deepening: without a TT move the ordering here falls back to
+    // MVV-LVA and killers. A cheaper reduced search of this same node stores its best move
+    // in the TT slot, so the full-depth search below starts with a good first move.
+    // Only PV nodes qualify: elsewhere the reduced search mostly fails low and finds no move.
+    if (is_pv_node && tt_move16 == 0 && !has_excluded_move && depth >= IID_MIN_DEPTH) {
+        alphaBeta(board, depth - IID_DEPTH_REDUCTION, alpha, beta, ply);
+        if (search_stopped()) {
+            return 0;
+        }
+        read_tt_entry();
     }
 
-    branches_explored_count += legal_moves.size();
+    bool window_is_mate_free = std::abs(alpha) < ChessAI::MATE_IN_MAX_PLY && std::abs(beta) < ChessAI::MATE_IN_MAX_PLY;
 
-    if (legal_moves.empty()) {
-        int terminal_score;
-        if (board.is_king_in_check(board.active_player)) {
-            terminal_score = -ChessAI::MATE_VALUE + (current_search_depth_set - depth);
-        } else {
-            terminal_score = 0;
+    if (!is_pv_node && !in_check && window_is_mate_free && !has_excluded_move) {
+        // Reverse futility pruning (static null move): we are so far above beta that
+        // the opponent is not expected to recover within the remaining depth.
+        if (depth <= REVERSE_FUTILITY_MAX_DEPTH &&
+            static_eval - REVERSE_FUTILITY_MARGIN * (depth - (improving ? 1 : 0)) >= beta) {
+            return beta;
         }
 
-        TTEntry new_entry;
-        new_entry.hash = current_hash;
-        new_entry.score = terminal_score;
-        new_entry.depth = depth;
-        new_entry.flag = NodeType::EXACT;
-        transposition_table[tt_index] = new_entry;
+        // Razoring: hopelessly below alpha, so only captures can save the node.
+        if (depth <= RAZORING_MAX_DEPTH && static_eval + RAZORING_MARGIN * depth < alpha) {
+            int razor_score = quiescence_search_internal(board, alpha, beta, ply);
+            if (search_stopped()) {
+                return 0;
+            }
+            if (razor_score <= alpha) {
+                return alpha;
+            }
+        }
+    }
 
-        return terminal_score;
+    // ProbCut: at a cut node, a good capture that beats beta by a margin in a reduced-depth
+    // search is trusted to fail high at full depth as well.
+    if (!is_pv_node && !in_check && !has_excluded_move && depth >= PROBCUT_MIN_DEPTH &&
+        std::abs(beta) < ChessAI::MATE_IN_MAX_PLY) {
+        int probcut_beta = beta + PROBCUT_MARGIN;
+        bool tt_refutes_probcut = tt_hit && tt_depth >= depth - (PROBCUT_DEPTH_REDUCTION - 1) &&
+                                  tt_bound != NodeType::LOWER_BOUND && tt_score < probcut_beta;
+
+        if (!tt_refutes_probcut) {
+            for (const auto& move : pseudo_legal_moves) {
+                if (move.piece_captured_type_idx == PieceTypeIndex::NONE && !move.is_promotion) {
+                    continue;
+                }
+                if (static_exchange_eval(board, move) < probcut_beta - static_eval) {
+                    continue;
+                }
+
+                StateInfo info_for_undo;
+                board.apply_move(move, info_for_undo);
+                transposition_table->prefetch(board.zobrist_hash);
+                if (board.is_king_in_check(us)) {
+                    board.undo_move(move, info_for_undo);
+                    continue;
+                }
+                ss.current_move = move;
+                ss.continuation_history = &continuation_history_storage[colored_piece_index(us, move.piece_moved_type_idx) * 64 + move_to_index(move)];
+
+                // A cheap quiescence check first, then the reduced search to confirm it.
+                int score = -quiescence_search_internal(board, -probcut_beta, -probcut_beta + 1, ply + 1);
+                if (score >= probcut_beta) {
+                    score = -alphaBeta(board, depth - PROBCUT_DEPTH_REDUCTION, -probcut_beta, -probcut_beta + 1, ply + 1);
+                }
+
+                board.undo_move(move, info_for_undo);
+                if (search_stopped()) {
+                    return 0;
+                }
+
+                if (score >= probcut_beta) {
+                    tt_entry->save(current_hash, score_to_tt(beta, ply), static_eval, NodeType::LOWER_BOUND,
+                                   depth - (PROBCUT_DEPTH_REDUCTION - 1), TranspositionTable::pack_move(move),
+                                   transposition_table->generation());
+                    return beta;
+                }
+            }
+        }
     }
 
+    // Futility pruning: quiet moves cannot lift the static eval up to alpha at this depth.
+    bool futility_pruning_allowed = !is_pv_node && !in_check && window_is_mate_free &&
+                                    depth <= FUTILITY_MAX_DEPTH &&
+                                    static_eval + FUTILITY_MARGIN_BASE + FUTILITY_MARGIN_PER_DEPTH * depth <= alpha;
+
     std::vector<std::pair<Move, int>> scored_moves;
-    scored_moves.reserve(legal_moves.size());
+    scored_moves.reserve(pseudo_legal_moves.size());
+
+    bool has_pv_move = ss.follows_pv && ply < static_cast<int>(principal_variation.size());
+
+    // The quiet move that refuted the opponent's last move the previous time it was played.
+    const Move& previous_move = search_stack[ply - 1].current_move;
+    PlayerColor them = (us == PlayerColor::White) ? PlayerColor::Black : PlayerColor::White;
+    int countermove_index = -1;
+    Move countermove = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
+    if (previous_move.piece_moved_type_idx != PieceTypeIndex::NONE) {
+        countermove_index = colored_piece_index(them, previous_move.piece_moved_type_idx) * 64 + move_to_index(previous_move);
+        countermove = countermove_moves_storage[countermove_index];
+    }
 
-    for (const auto& move : legal_moves) {
+    // The TT only keeps a packed move; finding it among the generated moves recovers the
+    // full Move and also proves it is pseudo-legal here.
+    Move tt_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
+
+    for (const auto& move : pseudo_legal_moves) {
         int move_score = 0;
+        bool is_tt_move = tt_move16 != 0 && TranspositionTable::pack_move(move) == tt_move16;
+        if (is_tt_move) {
+            tt_move = move;
+        }
 
-        if (entry.best_move.piece_moved_type_idx != PieceTypeIndex::NONE &&
-            move.from_square.x == entry.best_move.from_square.x &&
-            move.from_square.y == entry.best_move.from_square.y &&
-            move.to_square.x == entry.best_move.to_square.x &&
-            move.to_square.y == entry.best_move.to_square.y &&
-            move.piece_moved_type_idx == entry.best_move.piece_moved_type_idx) {
-            move_score = 100000;
+        if (has_pv_move && same_move(move, principal_variation[ply])) {
+            move_score = ORDER_PV_MOVE;
+        }
+        else if (is_tt_move) {
+            move_score = ORDER_TT_MOVE;
         }
         else if (move.piece_captured_type_idx != PieceTypeIndex::NONE) {
             move_score = PIECE_SORT_VALUES[static_cast<int>(move.piece_captured_type_idx)] * 10 
                          - PIECE_SORT_VALUES[static_cast<int>(move.piece_moved_type_idx)];
-            move_score += 10000; 
-        }
-        else if (current_ply < MAX_PLY) {
-            if (move.from_square.x == killer_moves_storage[current_ply * 2].from_square.x &&
-                move.from_square.y == killer_moves_storage[current_ply * 2].from_square.y &&
-                move.to_square.x == killer_moves_storage[current_ply * 2].to_square.x &&
-                move.to_square.y == killer_moves_storage[current_ply * 2].to_square.y &&
-                move.piece_moved_type_idx == killer_moves_storage[current_ply * 2].piece_moved_type_idx) {
-                move_score = 9000;
-            } else if (move.from_square.x == killer_moves_storage[current_ply * 2 + 1].from_square.x &&
-                       move.from_square.y == killer_moves_storage[current_ply * 2 + 1].from_square.y &&
-                       move.to_square.x == killer_moves_storage[current_ply * 2 + 1].to_square.x &&
-                       move.to_square.y == killer_moves_storage[current_ply * 2 + 1].to_square.y &&
-                       move.piece_moved_type_idx == killer_moves_storage[current_ply * 2 + 1].piece_moved_type_idx) {
-                move_score = 8000;
-            }
+            move_score += capture_history_storage[capture_history_index(us, move)] / CAPTURE_HISTORY_ORDER_DIVISOR;
+            move_score += ORDER_CAPTURE_BASE;
+        }
+        else if (same_move(move, ss.killers[0])) {
+            move_score = ORDER_KILLER_1;
+        }
+        else if (same_move(move, ss.killers[1])) {
+            move_score = ORDER_KILLER_2;
+        }
+        else if (same_move(move, countermove)) {
+            move_score = ORDER_COUNTERMOVE;
         }
         else {
-            int from_sq_idx = ChessBitboardUtils::rank_file_to_square(move.from_square.y, move.from_square.x);
-            int to_sq_idx = ChessBitboardUtils::rank_file_to_square(move.to_square.y, move.to_square.x);
-            history_scores_storage[from_sq_idx * 64 + to_sq_idx] += depth * depth; 
+            move_score = quiet_history_score(us, move, ply);
         }
 
         scored_moves.push_back({move, move_score});
@@ -281,46 +743,214 @@ int ChessAI::alphaBeta(ChessBoard& board, int depth, int alpha, int beta) {
         return a.second > b.second;
     });
 
+    // Enhanced transposition cutoffs: the child keys come from the incremental Zobrist update,
+    // so the TT can be probed for the children without making the moves. A child whose stored
+    // upper bound is low enough for us to reach beta proves the cutoff right away.
+    if (ENABLE_ETC && !is_pv_node && !has_excluded_move && depth >= ETC_MIN_DEPTH) {
+        int moves_probed = 0;
+        for (const auto& scored_move_pair : scored_moves) {
+            if (moves_probed++ >= ETC_MAX_MOVES) {
+                break;
+            }
+            const Move& move = scored_move_pair.first;
+            uint64_t child_hash = board.hash_after_move(move);
+            bool child_hit = false;
+            TTData child_data;
+            transposition_table->probe(child_hash, child_hit, child_data);
+            if (!child_hit || child_data.depth() < depth - 1 ||
+                child_data.bound() == NodeType::LOWER_BOUND ||
+                std::abs(child_data.score()) >= ChessAI::MATE_IN_MAX_PLY) {
+                continue;
+            }
+            if (-child_data.score() >= beta) {
+                tt_entry->save(current_hash, score_to_tt(beta, ply), static_eval, NodeType::LOWER_BOUND, depth,
+                               TranspositionTable::pack_move(move), transposition_table->generation());
+                return beta;
+            }
+        }
+    }
+
+    // Singular extension: if the TT move is clearly better than every alternative, as shown by
+    // a reduced search of this node with the TT move excluded, it gets one extra ply.
+    bool extensions_allowed = ply < EXTENSION_PLY_LIMIT_FACTOR * current_search_depth_set &&
+                              ply + depth < MAX_PLY - 1;
+    Move singular_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
+    if (extensions_allowed && !has_excluded_move && depth >= SINGULAR_EXTENSION_MIN_DEPTH &&
+        tt_hit && tt_move.piece_moved_type_idx != PieceTypeIndex::NONE &&
+        tt_depth >= depth - 3 && tt_bound != NodeType::UPPER_BOUND &&
+        std::abs(tt_score) < ChessAI::MATE_IN_MAX_PLY) {
+        int singular_beta = tt_score - SINGULAR_MARGIN_PER_DEPTH * depth;
+
+        ss.excluded_move = tt_move;
+        int singular_score = alphaBeta(board, (depth - 1) / 2, singular_beta - 1, singular_beta, ply);
+        ss.excluded_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
+        if (search_stopped()) {
+            return 0;
+        }
+
+        if (singular_score < singular_beta) {
+            singular_move = tt_move;
+        }
+    }
+
     Move best_move_this_node = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
 
+    // The IID and singular searches above ran at this ply too; drop the lines they left behind.
+    pv_length_storage[ply] = ply;
+
+    int moves_searched = 0;
+    std::vector<Move> quiet_moves_searched;
+    quiet_moves_searched.reserve(scored_moves.size());
+    std::vector<Move> captures_searched;
+
+    bool quiet_pruning_allowed = !is_pv_node && !in_check && window_is_mate_free;
+
     for (const auto& scored_move_pair : scored_moves) {
         const Move& move = scored_move_pair.first;
+        if (has_excluded_move && same_move(move, excluded_move)) {
+            continue;
+        }
+        bool is_quiet = move.piece_captured_type_idx == PieceTypeIndex::NONE &&
+                        move.promotion_piece_type_idx == PieceTypeIndex::NONE;
+        bool is_capture = move.piece_captured_type_idx != PieceTypeIndex::NONE;
+        bool is_killer = scored_move_pair.second == ORDER_KILLER_1 || scored_move_pair.second == ORDER_KILLER_2;
+
+        int history_score = 0;
+        if (is_quiet) {
+            history_score = quiet_history_score(us, move, ply);
+        }
+
+        if (quiet_pruning_allowed && is_quiet && moves_searched > 0) {
+            // Late move pruning: enough quiet moves have failed to cut already.
+            if (depth <= LATE_MOVE_PRUNING_MAX_DEPTH &&
+                static_cast<int>(quiet_moves_searched.size()) >= (LATE_MOVE_PRUNING_BASE + depth * depth) / (improving ? 1 : 2)) {
+                continue;
+            }
+            // History pruning: this quiet move has kept failing elsewhere in the tree.
+            if (depth <= HISTORY_PRUNING_MAX_DEPTH && !is_killer &&
+                history_score < -HISTORY_PRUNING_THRESHOLD * depth) {
+                continue;
+            }
+        }
 
         StateInfo info_for_undo;
         board.apply_move(move, info_for_undo);
+        transposition_table->prefetch(board.zobrist_hash);
+        prefetch_eval_cache(board.zobrist_hash);
+        if (board.is_king_in_check(us)) {
+            board.undo_move(move, info_for_undo);
+            continue;
+        }
+        branches_explored_count++;
+        ss.current_move = move;
+        ss.continuation_history = &continuation_history_storage[colored_piece_index(us, move.piece_moved_type_idx) * 64 + move_to_index(move)];
+        bool gives_check = board.is_king_in_check(board.active_player);
+
+        if (futility_pruning_allowed && moves_searched > 0 && is_quiet && !gives_check) {
+            board.undo_move(move, info_for_undo);
+            continue;
+        }
+
+        int extension = 0;
+        if (extensions_allowed && (gives_check || same_move(move, singular_move))) {
+            extension = 1;
+        }
+        int new_depth = depth - 1 + extension;
+
+        int score;
+        if (moves_searched == 0) {
+            score = -alphaBeta(board, new_depth, -beta, -alpha, ply + 1);
+        } else {
+            // Late Move Reductions: late quiet moves get a reduced-depth null-window search first.
+            int reduction = 0;
+            if (depth >= LMR_MIN_DEPTH && moves_searched >= LMR_MIN_MOVE_NUMBER && is_quiet && !in_check) {
+                reduction = LMR_TABLE[std::min(depth, MAX_PLY - 1)][std::min(moves_searched, LMR_MAX_MOVE_NUMBER - 1)];
+                if (is_pv_node) reduction--;
+                if (is_killer) reduction--;
+                if (gives_check) reduction--;
+                if (!improving) reduction++;
+                reduction -= std::clamp(history_score / LMR_HISTORY_DIVISOR, -2, 2);
+
+                reduction = std::clamp(reduction, 0, new_depth - 1); // Never drop straight into quiescence.
+            }
 
-        int score = -alphaBeta(board, depth - 1, -beta, -alpha);
+            // Principal Variation Search: every move after the first is expected to fail low,
+            // so prove that with a null window and only re-search when it beats alpha.
+            score = -alphaBeta(board, new_depth - reduction, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && reduction > 0) {
+                score = -alphaBeta(board, new_depth, -alpha - 1, -alpha, ply + 1);
+            }
+            if (score > alpha && score < beta) {
+                score = -alphaBeta(board, new_depth, -beta, -alpha, ply + 1);
+            }
+        }
         
         board.undo_move(move, info_for_undo);
+        if (search_stopped()) {
+            return 0;
+        }
+        moves_searched++;
 
         if (score >= beta) {
-            TTEntry new_entry;
-            new_entry.hash = current_hash;
-            new_entry.score = beta;
-            new_entry.depth = depth;
-            new_entry.flag = NodeType::LOWER_BOUND;
-            new_entry.best_move = move; 
-            transposition_table[tt_index] = new_entry;
-
-            if (move.piece_captured_type_idx == PieceTypeIndex::NONE &&
-                move.promotion_piece_type_idx == PieceTypeIndex::NONE &&
-                current_ply < MAX_PLY) {
-                killer_moves_storage[current_ply * 2 + 1] = killer_moves_storage[current_ply * 2];
-                killer_moves_storage[current_ply * 2] = move;
+            if (!has_excluded_move) {
+                tt_entry->save(current_hash, score_to_tt(beta, ply), static_eval, NodeType::LOWER_BOUND, depth,
+                               TranspositionTable::pack_move(move), transposition_table->generation());
+            }
+
+            if (is_quiet && !same_move(move, ss.killers[0])) {
+                ss.killers[1] = ss.killers[0];
+                ss.killers[0] = move;
+            }
+            // Reward the refutation and penalize the moves of its kind that were tried before it,
+            // so that persistently useless moves end up with negative history.
+            int bonus = history_bonus(depth);
+            if (is_quiet) {
+                if (countermove_index >= 0) {
+                    countermove_moves_storage[countermove_index] = move;
+                }
+                update_quiet_histories(us, move, ply, bonus);
+                for (const auto& failed_quiet : quiet_moves_searched) {
+                    update_quiet_histories(us, failed_quiet, ply, -bonus);
+                }
+            } else if (is_capture) {
+                apply_history_bonus(capture_history_storage[capture_history_index(us, move)], bonus);
+            }
+            for (const auto& failed_capture : captures_searched) {
+                apply_history_bonus(capture_history_storage[capture_history_index(us, failed_capture)], -bonus);
             }
             return beta;
         }
+        if (is_quiet) {
+            quiet_moves_searched.push_back(move);
+        } else if (is_capture) {
+            captures_searched.push_back(move);
+        }
         if (score > alpha) {
             alpha = score;
             best_move_this_node = move;
+            update_pv(ply, move);
+        }
+    }
 
-            if (move.piece_captured_type_idx == PieceTypeIndex::NONE &&
-                move.promotion_piece_type_idx == PieceTypeIndex::NONE) {
-                int from_sq_idx = ChessBitboardUtils::rank_file_to_square(move.from_square.y, move.from_square.x);
-                int to_sq_idx = ChessBitboardUtils::rank_file_to_square(move.to_square.y, move.to_square.x);
-                history_scores_storage[from_sq_idx * 64 + to_sq_idx] += depth * depth; 
-            }
+    // moves_searched counts the legal moves played. Moves are only pruned after the first one
+    // has been searched, so zero here means there was no legal move (other than an excluded one).
+    if (moves_searched == 0) {
+        if (has_excluded_move) {
+            // The excluded move is the only legal move, so it is trivially singular.
+            return alpha;
         }
+
+        int terminal_score;
+        if (in_check) {
+            terminal_score = -ChessAI::MATE_VALUE + ply;
+        } else {
+            terminal_score = 0;
+        }
+
+        tt_entry->save(current_hash, score_to_tt(terminal_score, ply), static_eval, NodeType::EXACT, depth, 0,
+                       transposition_table->generation());
+
+        return terminal_score;
     }
 
     NodeType flag_to_store;
@@ -330,30 +960,162 @@ int ChessAI::alphaBeta(ChessBoard& board, int depth, int alpha, int beta) {
         flag_to_store = NodeType::EXACT;
     }
 
-    TTEntry new_entry;
-    new_entry.hash = current_hash;
-    new_entry.score = alpha;
-    new_entry.depth = depth;
-    new_entry.flag = flag_to_store;
-    new_entry.best_move = best_move_this_node; 
-    transposition_table[tt_index] = new_entry;
+    if (!has_excluded_move) {
+        tt_entry->save(current_hash, score_to_tt(alpha, ply), static_eval, flag_to_store, depth,
+                       TranspositionTable::pack_move(best_move_this_node), transposition_table->generation());
+    }
     
     return alpha;
 }
 
-Move ChessAI::findBestMove(ChessBoard& board) {
+// Helpers skip some iterations so that they spread over different depths instead of all
+// searching the same tree in lockstep (helper i uses entry (i - 1) % 20 of these tables).
+static constexpr int HELPER_SKIP_SIZE[]  = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+static constexpr int HELPER_SKIP_PHASE[] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+// Helpers stop at most this many plies beyond the main thread's target depth. Without a cap,
+// a helper in a short or forced position runs through dozens of trivial iterations before the
+// main thread finishes, and its meaningless depth would win the result selection.
+static constexpr int HELPER_MAX_EXTRA_DEPTH = 2;
+
+void ChessAI::iterative_deepening(ChessBoard& board) {
     nodes_evaluated_count = 0;
     branches_explored_count = 0;
-    current_search_depth_set = AI_SEARCH_DEPTH; 
+    completed_depth = 0;
+    completed_score = 0;
+    completed_best_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
 
-    for (int i = 0; i < MAX_PLY; ++i) {
-        killer_moves_storage[i * 2] = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
-        killer_moves_storage[i * 2 + 1] = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
+    for (auto& stack_entry : search_stack) {
+        stack_entry = SearchStack();
+    }
+    // Histories carry over from the previous search, halved so that stale statistics fade out.
+    for (auto& value : history_scores_storage) {
+        value /= 2;
+    }
+    for (auto& value : capture_history_storage) {
+        value /= 2;
     }
-    for (size_t i = 0; i < history_scores_storage.size(); ++i) {
-        history_scores_storage[i] = 0;
+    for (auto& table : continuation_history_storage) {
+        for (auto& row : table) {
+            for (auto& value : row) {
+                value /= 2;
+            }
+        }
+    }
+    principal_variation.clear();
+
+    std::vector<Move> legal_moves = move_gen.generate_legal_moves(board);
+    if (legal_moves.empty()) {
+        return;
     }
 
+    PlayerColor original_active_player = board.active_player;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    // The main thread stops at AI_SEARCH_DEPTH; helpers alternate between one and two plies
+    // beyond it, unless the main thread is done first.
+    int max_depth = static_cast<int>(AI_SEARCH_DEPTH);
+    if (thread_index > 0) {
+        max_depth += 1 + thread_index % HELPER_MAX_EXTRA_DEPTH;
+    }
+    max_depth = std::min(max_depth, MAX_PLY - 1);
+
+    // Iterative deepening: every iteration searches the previous iteration's PV first,
+    // so the deeper searches start from a good ordering and refute the rest quickly.
+    for (int iteration_depth = 1; iteration_depth <= max_depth && !search_stopped(); ++iteration_depth) {
+        if (thread_index > 0) {
+            int skip_index = (thread_index - 1) % 20;
+            if (((iteration_depth + HELPER_SKIP_PHASE[skip_index]) / HELPER_SKIP_SIZE[skip_index]) % 2 != 0) {
+                continue;
+            }
+        }
+
+        current_search_depth_set = iteration_depth;
+        search_stack[0].follows_pv = true;
+        pv_length_storage[0] = 0;
+
+        if (!principal_variation.empty()) {
+            auto pv_move_it = std::find_if(legal_moves.begin(), legal_moves.end(), [&](const Move& move) {
+                return same_move(move, principal_variation[0]);
+            });
+            if (pv_move_it != legal_moves.end()) {
+                std::rotate(legal_moves.begin(), pv_move_it, pv_move_it + 1);
+            }
+        }
+
+        Move iteration_best_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
+        int iteration_best_eval = -ChessAI::MATE_VALUE - 1;
+        int alpha = -ChessAI::MATE_VALUE - 1;
+        int beta = ChessAI::MATE_VALUE + 1;
+
+        for (const auto& move : legal_moves) {
+            StateInfo info_for_undo;
+            board.apply_move(move, info_for_undo);
+            transposition_table->prefetch(board.zobrist_hash);
+            search_stack[0].current_move = move;
+            search_stack[0].continuation_history =
+                &continuation_history_storage[colored_piece_index(original_active_player, move.piece_moved_type_idx) * 64 + move_to_index(move)];
+
+            int current_score;
+            if (iteration_best_move.piece_moved_type_idx == PieceTypeIndex::NONE) {
+                current_score = -alphaBeta(board, iteration_depth - 1, -beta, -alpha, 1);
+            } else {
+                current_score = -alphaBeta(board, iteration_depth - 1, -alpha - 1, -alpha, 1);
+                if (current_score > alpha) {
+                    current_score = -alphaBeta(board, iteration_depth - 1, -beta, -alpha, 1);
+                }
+            }
+            board.undo_move(move, info_for_undo);
+            if (search_stopped()) {
+                break;
+            }
+
+            if (current_score > iteration_best_eval) {
+                iteration_best_eval = current_score;
+                iteration_best_move = move;
+            }
+            if (current_score > alpha) {
+                alpha = current_score;
+                update_pv(0, move);
+            }
+            if (alpha >= beta) {
+                break; 
+            }
+        }
+
+        // An interrupted iteration has not seen every root move, so its result is dropped.
+        if (search_stopped()) {
+            break;
+        }
+
+        completed_depth = iteration_depth;
+        completed_score = iteration_best_eval;
+        completed_best_move = iteration_best_move;
+        principal_variation.assign(pv_table_storage.begin(), pv_table_storage.begin() + pv_length_storage[0]);
+
+        if (uci_output != nullptr) {
+            long long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - start_time).count();
+            long long nodes_per_second = 0;
+            if (duration_ms > 0) {
+                nodes_per_second = (static_cast<long long>(nodes_evaluated_count) * 1000) / duration_ms;
+            } else if (nodes_evaluated_count > 0) {
+                nodes_per_second = static_cast<long long>(nodes_evaluated_count) * 1000000;
+            }
+
+            std::string pv_string;
+            for (const auto& pv_move : principal_variation) {
+                if (!pv_string.empty()) pv_string += " ";
+                pv_string += ChessBitboardUtils::move_to_string(pv_move);
+            }
+            uci_output->sendSearchInfo(iteration_depth, score_to_uci(completed_score), nodes_evaluated_count,
+                                       duration_ms, nodes_per_second, pv_string);
+        }
+    }
+}
+
+Move ChessAI::findBestMove(ChessBoard& board) {
+    ponder_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
 
     std::vector<Move> legal_moves = move_gen.generate_legal_moves(board);
 
@@ -364,42 +1126,105 @@ Move ChessAI::findBestMove(ChessBoard& board) {
 
     PlayerColor original_active_player = board.active_player;
 
-    Move final_chosen_move = Move({0,0}, {0,0}, PieceTypeIndex::NONE);
-    int best_eval = -ChessAI::MATE_VALUE - 1;
-    int alpha = -ChessAI::MATE_VALUE - 1;
-    int beta = ChessAI::MATE_VALUE + 1;
+    transposition_table->new_search();
+    stop_search->store(false);
+
+    // Helpers are kept between searches, so their histories carry over like the main thread's.
+    // They run as tasks on the persistent pool, so starting them costs no thread creation.
+    size_t helper_count = 0;
+    if (thread_pool != nullptr) {
+        helper_count = std::min(std::max<size_t>(thread_count, 1) - 1, thread_pool->size());
+    }
+    while (helper_threads.size() < helper_count) {
+        helper_threads.push_back(std::make_unique<ChessAI>(transposition_table, stop_search,
+                                                           static_cast<int>(helper_threads.size()) + 1));
+    }
+    helper_threads.resize(helper_count);
 
     auto start_time = std::chrono::high_resolution_clock::now();
-    for (const auto& move : legal_moves) {
-        StateInfo info_for_undo;
-        board.apply_move(move, info_for_undo);
 
-        int current_score = -alphaBeta(board, AI_SEARCH_DEPTH - 1, -beta, -alpha); // Use AI_SEARCH_DEPTH directly
-        board.undo_move(move, info_for_undo);
+    for (auto& helper : helper_threads) {
+        ChessAI* helper_ai = helper.get();
+        thread_pool->submit([helper_ai, helper_board = board]() mutable {
+            helper_ai->iterative_deepening(helper_board);
+        });
+    }
+
+    iterative_deepening(board);
+
+    stop_search->store(true);
+    if (thread_pool != nullptr) {
+        thread_pool->wait();
+    }
 
-        if (current_score > best_eval) {
-            best_eval = current_score;
-            final_chosen_move = move;
+    // The thread that completed the deepest iteration reports the result, counting only depths
+    // within HELPER_MAX_EXTRA_DEPTH of the main thread's; at equal depth the higher score wins.
+    // Otherwise the main thread wins, since its iterations were not skipped and its PV is the
+    // most consistent.
+    ChessAI* best_thread = this;
+    int depth_limit = completed_depth + HELPER_MAX_EXTRA_DEPTH;
+    unsigned long long total_nodes = nodes_evaluated_count;
+    unsigned long long total_branches = branches_explored_count;
+    for (auto& helper : helper_threads) {
+        total_nodes += helper->nodes_evaluated_count;
+        total_branches += helper->branches_explored_count;
+        if (helper->completed_depth > depth_limit || helper->completed_best_move.piece_moved_type_idx == PieceTypeIndex::NONE) {
+            continue;
         }
-        alpha = std::max(alpha, current_score);
-        if (alpha >= beta) {
-            break; 
+        if (helper->completed_depth > best_thread->completed_depth ||
+            (helper->completed_depth == best_thread->completed_depth && helper->completed_score > best_thread->completed_score)) {
+            best_thread = helper.get();
         }
     }
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration_microseconds = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-    long long duration_ms = duration_microseconds.count() / 1000;
 
+    Move final_chosen_move = best_thread->completed_best_move;
+    int best_eval = best_thread->completed_score;
+    const std::vector<Move>& best_pv = best_thread->principal_variation;
+
+    auto now = std::chrono::high_resolution_clock::now();
+    long long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(now - start_time).count();
     long long nodes_per_second = 0;
     if (duration_ms > 0) {
-        nodes_per_second = (static_cast<long long>(nodes_evaluated_count) * 1000) / duration_ms;
-    } else if (nodes_evaluated_count > 0) {
-        nodes_per_second = static_cast<long long>(nodes_evaluated_count) * 1000000;
+        nodes_per_second = (static_cast<long long>(total_nodes) * 1000) / duration_ms;
+    } else if (total_nodes > 0) {
+        nodes_per_second = static_cast<long long>(total_nodes) * 1000000;
+    }
+
+    if (uci_output != nullptr && best_thread != this) {
+        std::string pv_string;
+        for (const auto& pv_move : best_pv) {
+            if (!pv_string.empty()) pv_string += " ";
+            pv_string += ChessBitboardUtils::move_to_string(pv_move);
+        }
+        uci_output->sendSearchInfo(best_thread->completed_depth, score_to_uci(best_eval), total_nodes,
+                                   duration_ms, nodes_per_second, pv_string);
+    }
+
+    // The ponder move is the second PV move. A PV cut short by a TT hit still leaves the
+    // reply in the TT, as long as it is legal in the position after our move.
+    if (best_pv.size() >= 2) {
+        ponder_move = best_pv[1];
+    } else {
+        StateInfo info_for_undo;
+        board.apply_move(final_chosen_move, info_for_undo);
+        bool reply_hit = false;
+        TTData reply_data;
+        transposition_table->probe(board.zobrist_hash, reply_hit, reply_data);
+        if (reply_hit && reply_data.move() != 0) {
+            for (const auto& reply : move_gen.generate_legal_moves(board)) {
+                if (TranspositionTable::pack_move(reply) == reply_data.move()) {
+                    ponder_move = reply;
+                    break;
+                }
+            }
+        }
+        board.undo_move(final_chosen_move, info_for_undo);
     }
 
-    std::cerr << "DEBUG: Carolyna: Completed search to depth " << current_search_depth_set
-              << ". Nodes: " << nodes_evaluated_count
-              << ", Branches: " << branches_explored_count
+    std::cerr << "DEBUG: Carolyna: Completed search to depth " << best_thread->completed_depth
+              << " (" << helper_count + 1 << " threads)"
+              << ". Nodes: " << total_nodes
+              << ", Branches: " << total_branches
               << ", Time: " << duration_ms << "ms"
               << ", NPS: " << nodes_per_second << std::endl;
     
@@ -409,8 +1234,9 @@ Move ChessAI::findBestMove(ChessBoard& board) {
     }
 
     std::string score_string;
-    if (std::abs(final_display_score) >= ChessAI::MATE_VALUE) {
-        score_string = "mate " + std::to_string((ChessAI::MATE_VALUE - std::abs(final_display_score) + current_search_depth_set) * (final_display_score > 0 ? 1 : -1));
+    if (std::abs(final_display_score) > ChessAI::MATE_IN_MAX_PLY) {
+        int mate_in_moves = (ChessAI::MATE_VALUE - std::abs(final_display_score) + 1) / 2;
+        score_string = "mate " + std::to_string(mate_in_moves * (final_display_score > 0 ? 1 : -1));
     } else if (final_display_score > 0) {
         score_string = "+" + std::to_string(final_display_score);
     } else if (final_display_score < 0) {
@@ -7,10 +7,16 @@
 #include "Move.h"
 #include "Types.h"
 #include "ChessBitboardUtils.h" 
+#include "UciHandler.h"
+#include "TranspositionTable.h"
+#include "ThreadPool.h"
 
 #include <vector>
+#include <string>
 #include <cstdint>
 #include <array>
+#include <atomic>
+#include <memory>
 
 // Forward declaration of Evaluation namespace and its evaluate function
 namespace Evaluation {
@@ -18,33 +24,24 @@ namespace Evaluation {
 }
 
 
-struct ChessAI {
+// Aligned to a cache line so that the search data of two threads (the node counters above
+// all, which are written at every node) never shares a line and causes false sharing.
+struct alignas(64) ChessAI {
 	MoveGenerator move_gen;
 
 	unsigned long long nodes_evaluated_count;
 	unsigned long long branches_explored_count;
 	int current_search_depth_set;
 
-	static constexpr size_t TT_SIZE = 1048576;
 	static constexpr int MATE_VALUE = 30000;
     static constexpr int MAX_PLY = 64; // Max search ply (corresponds to max depth)
+    // Every mate score lies beyond this: the search never reports a mate from MAX_PLY or deeper.
+    static constexpr int MATE_IN_MAX_PLY = MATE_VALUE - MAX_PLY;
+    static constexpr int EVAL_NONE = MATE_VALUE + 2; // Marks a missing static eval (e.g. in check)
 
-	struct TTEntry {
-		uint64_t hash;
-		int score;
-		int depth;
-		NodeType flag;
-		Move best_move;
-
-        TTEntry() :
-            hash(0ULL),
-            score(0),
-            depth(0),
-            flag(NodeType::EXACT),
-            best_move({0,0}, {0,0}, PieceTypeIndex::NONE)
-        {}
-	};
-	std::vector<TTEntry> transposition_table;
+	// Shared by the main search and all of its Lazy SMP helpers.
+	std::shared_ptr<TranspositionTable> transposition_table;
+	std::shared_ptr<std::atomic<bool>> stop_search; // Set once the main search is done; helpers then unwind.
 
     // PST tables remain here as they are large data arrays
 	static constexpr int PAWN_PST[64] = {
@@ -113,15 +110,97 @@ struct ChessAI {
 		20,  30,  10,   0,   0,  10,  30,  20
 	};
 
-    std::vector<Move> killer_moves_storage;
+    // History scores indexed by [colored piece (0-11)][destination square].
+    using PieceToHistory = std::array<std::array<int, 64>, 12>;
+
+    // Per-ply search state, indexed by the real distance from the root (the root is ply 0).
+    struct SearchStack {
+        int static_eval;                      // Side-to-move static eval, or EVAL_NONE when in check.
+        uint64_t static_eval_hash;            // Position static_eval was computed for.
+        Move current_move;                    // Move currently being searched from this ply.
+        Move killers[2];                      // Quiet moves that recently caused a cutoff at this ply.
+        Move excluded_move;                   // TT move skipped by a singular extension search.
+        PieceToHistory* continuation_history; // History table for the replies to current_move.
+        bool follows_pv;                      // Every move from the root to here was on the previous PV.
+
+        SearchStack() :
+            static_eval(EVAL_NONE),
+            static_eval_hash(0ULL),
+            current_move({0,0}, {0,0}, PieceTypeIndex::NONE),
+            killers{ Move({0,0}, {0,0}, PieceTypeIndex::NONE), Move({0,0}, {0,0}, PieceTypeIndex::NONE) },
+            excluded_move({0,0}, {0,0}, PieceTypeIndex::NONE),
+            continuation_history(nullptr),
+            follows_pv(false)
+        {}
+    };
+    std::vector<SearchStack> search_stack;
+
+    // Butterfly history of quiet moves, indexed by [color][from][to] (color * 4096 + from * 64 + to).
     std::vector<int> history_scores_storage;
+    // Capture history, indexed by [colored piece][to][captured type] ((piece * 64 + to) * 6 + captured).
+    std::vector<int> capture_history_storage;
+    // Continuation history: one PieceToHistory per [colored piece][to] of the previous move,
+    // scoring the replies to it. SearchStack::continuation_history points into this table.
+    std::vector<PieceToHistory> continuation_history_storage;
+    // Countermoves: the quiet move that last refuted the opponent's move, indexed by
+    // [colored piece][to] of that move (piece * 64 + to).
+    std::vector<Move> countermove_moves_storage;
+
+    // Triangular PV table: the best line found from `ply` is stored at
+    // pv_table_storage[ply * MAX_PLY + ply .. ply * MAX_PLY + pv_length_storage[ply]).
+    std::vector<Move> pv_table_storage;
+    std::vector<int> pv_length_storage;
+
+    // Direct-mapped cache of static evaluations, indexed by the low bits of the Zobrist key.
+    // Unlike the TT, which only keeps the evals of positions that were searched and survived
+    // replacement, it remembers every evaluation this thread made recently.
+    struct EvalCacheEntry {
+        uint64_t key;
+        int eval; // White's point of view, as returned by Evaluation::evaluate.
+    };
+    std::vector<EvalCacheEntry> eval_cache_storage;
+
+    // Result of the last completed iteration. The next iteration searches this line first.
+    std::vector<Move> principal_variation;
+    Move ponder_move; // Expected reply to the chosen move, or a NONE move if unknown.
+
+    // Receives the UCI "info" line after every iteration. Optional (may be null).
+    UciHandler* uci_output;
+
+    // Lazy SMP: thread_count - 1 helpers search the same position on their own board, stack and
+    // histories, sharing only the TT. What they store there speeds up and reorders the main search.
+    size_t thread_count;
+    int thread_index; // 0 for the main search, 1.. for helpers.
+    ThreadPool* thread_pool; // Runs the helpers. Optional (without it the search is single-threaded).
+    std::vector<std::unique_ptr<ChessAI>> helper_threads;
+
+    // Result of the deepest iteration this thread completed.
+    int completed_depth;
+    int completed_score;
+    Move completed_best_move;
 
 	ChessAI();
-	int alphaBeta(ChessBoard& board, int depth, int alpha, int beta);
+	// Creates a helper search that shares the given TT and stop flag.
+	ChessAI(std::shared_ptr<TranspositionTable> shared_table, std::shared_ptr<std::atomic<bool>> shared_stop, int index);
+	int alphaBeta(ChessBoard& board, int depth, int alpha, int beta, int ply);
 	Move findBestMove(ChessBoard& board);
 
 private:
-    int quiescence_search_internal(ChessBoard& board_ref, int alpha, int beta);
+    // Runs the iterative deepening loop of one thread and records its result in completed_*.
+    void iterative_deepening(ChessBoard& board);
+    bool search_stopped() const { return stop_search->load(std::memory_order_relaxed); }
+    // qsearch_depth is 0 on the first quiescence ply and decreases by one per ply below it.
+    int quiescence_search_internal(ChessBoard& board_ref, int alpha, int beta, int ply, int qsearch_depth = 0);
+    void update_pv(int ply, const Move& move);
+    // Static evaluation from the side to move's point of view, served from the eval cache when possible.
+    int static_evaluation(const ChessBoard& board);
+    // Same, but the evaluation may stop early once the score is known to lie outside the
+    // side-to-move window (alpha, beta). is_exact is false when a bound was returned instead;
+    // bounds are never cached.
+    int static_evaluation(const ChessBoard& board, int alpha, int beta, bool& is_exact);
+    void prefetch_eval_cache(uint64_t key) const;
+    int quiet_history_score(PlayerColor side, const Move& move, int ply) const;
+    void update_quiet_histories(PlayerColor side, const Move& move, int ply, int bonus);
 };
 
 #endif // CHESS_AI_H
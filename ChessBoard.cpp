@@ -31,8 +31,12 @@ ChessBoard::ChessBoard(const std::string& fen) {
     set_from_fen(fen);
 }
 
+uint64_t ChessBoard::zobrist_seed() {
+    return std::hash<std::string>{}("Carolyna is where my mind rests!");
+}
+
 void ChessBoard::initialize_zobrist_keys() {
-    std::mt19937_64 rng(std::hash<std::string>{}("Carolyna is where my mind rests!"));
+    std::mt19937_64 rng(zobrist_seed());
     std::uniform_int_distribution<uint64_t> dist;
 
     for (int i = 0; i < 12; ++i) {
@@ -751,6 +755,18 @@ bool ChessBoard::is_king_in_check(PlayerColor king_color) const {
     return false;
 }
 
+uint64_t ChessBoard::attackers_to(int square_idx, uint64_t occupancy) const {
+    uint64_t rook_like = white_rooks | black_rooks | white_queens | black_queens;
+    uint64_t bishop_like = white_bishops | black_bishops | white_queens | black_queens;
+
+    return (ChessBitboardUtils::pawn_attacks[static_cast<int>(PlayerColor::Black)][square_idx] & white_pawns) |
+           (ChessBitboardUtils::pawn_attacks[static_cast<int>(PlayerColor::White)][square_idx] & black_pawns) |
+           (ChessBitboardUtils::knight_attacks[square_idx] & (white_knights | black_knights)) |
+           (ChessBitboardUtils::king_attacks[square_idx] & (white_king | black_king)) |
+           (ChessBitboardUtils::get_rook_attacks(square_idx, occupancy) & rook_like) |
+           (ChessBitboardUtils::get_bishop_attacks(square_idx, occupancy) & bishop_like);
+}
+
 int ChessBoard::get_piece_square_index(PieceTypeIndex piece_type_idx, PlayerColor piece_color) const {
     uint64_t target_bb = 0ULL;
 
@@ -817,3 +833,77 @@ void ChessBoard::toggle_zobrist_piece(PieceTypeIndex piece_type_idx, PlayerColor
     int zobrist_index = static_cast<int>(piece_type_idx) + (piece_color == PlayerColor::White ? 0 : 6);
     zobrist_hash ^= zobrist_piece_keys[zobrist_index][square_idx];
 }
+
+uint64_t ChessBoard::hash_after_move(const Move& move) const {
+    const int us = (active_player == PlayerColor::White) ? 0 : 6;
+    const int them = 6 - us;
+    int from_sq = ChessBitboardUtils::rank_file_to_square(move.from_square.y, move.from_square.x);
+    int to_sq = ChessBitboardUtils::rank_file_to_square(move.to_square.y, move.to_square.x);
+
+    uint64_t hash = zobrist_hash ^ zobrist_black_to_move_key;
+    if (en_passant_square_idx != 64) {
+        hash ^= zobrist_en_passant_keys[ChessBitboardUtils::square_to_file(en_passant_square_idx)];
+    }
+
+    // Captured piece (en passant captures the pawn behind the target square).
+    if (move.piece_captured_type_idx != PieceTypeIndex::NONE) {
+        int captured_sq = to_sq;
+        if (move.is_en_passant) {
+            captured_sq = (active_player == PlayerColor::White) ? to_sq - 8 : to_sq + 8;
+        }
+        hash ^= zobrist_piece_keys[static_cast<int>(move.piece_captured_type_idx) + them][captured_sq];
+    }
+
+    // Moving piece, replaced by the promotion piece on the destination square.
+    hash ^= zobrist_piece_keys[static_cast<int>(move.piece_moved_type_idx) + us][from_sq];
+    if (move.is_promotion) {
+        hash ^= zobrist_piece_keys[static_cast<int>(move.promotion_piece_type_idx) + us][to_sq];
+    } else {
+        hash ^= zobrist_piece_keys[static_cast<int>(move.piece_moved_type_idx) + us][to_sq];
+    }
+
+    // Castling rook.
+    if (move.is_kingside_castle || move.is_queenside_castle) {
+        int rook_from_sq, rook_to_sq;
+        if (active_player == PlayerColor::White) {
+            rook_from_sq = move.is_kingside_castle ? ChessBitboardUtils::H1_SQ : ChessBitboardUtils::A1_SQ;
+            rook_to_sq = move.is_kingside_castle ? ChessBitboardUtils::F1_SQ : ChessBitboardUtils::D1_SQ;
+        } else {
+            rook_from_sq = move.is_kingside_castle ? ChessBitboardUtils::H8_SQ : ChessBitboardUtils::A8_SQ;
+            rook_to_sq = move.is_kingside_castle ? ChessBitboardUtils::F8_SQ : ChessBitboardUtils::D8_SQ;
+        }
+        int rook_index = static_cast<int>(PieceTypeIndex::ROOK) + us;
+        hash ^= zobrist_piece_keys[rook_index][rook_from_sq] ^ zobrist_piece_keys[rook_index][rook_to_sq];
+    }
+
+    // Castling rights.
+    uint8_t new_castling_rights = castling_rights_mask;
+    if (move.piece_moved_type_idx == PieceTypeIndex::KING) {
+        if (active_player == PlayerColor::White) {
+            new_castling_rights &= ~(ChessBitboardUtils::CASTLE_WK_BIT | ChessBitboardUtils::CASTLE_WQ_BIT);
+        } else {
+            new_castling_rights &= ~(ChessBitboardUtils::CASTLE_BK_BIT | ChessBitboardUtils::CASTLE_BQ_BIT);
+        }
+    }
+    if (move.piece_moved_type_idx == PieceTypeIndex::ROOK) {
+        if (from_sq == ChessBitboardUtils::A1_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_WQ_BIT;
+        if (from_sq == ChessBitboardUtils::H1_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_WK_BIT;
+        if (from_sq == ChessBitboardUtils::A8_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_BQ_BIT;
+        if (from_sq == ChessBitboardUtils::H8_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_BK_BIT;
+    }
+    if (move.piece_captured_type_idx == PieceTypeIndex::ROOK) {
+        if (to_sq == ChessBitboardUtils::A1_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_WQ_BIT;
+        if (to_sq == ChessBitboardUtils::H1_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_WK_BIT;
+        if (to_sq == ChessBitboardUtils::A8_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_BQ_BIT;
+        if (to_sq == ChessBitboardUtils::H8_SQ) new_castling_rights &= ~ChessBitboardUtils::CASTLE_BK_BIT;
+    }
+    hash ^= zobrist_castling_keys[castling_rights_mask] ^ zobrist_castling_keys[new_castling_rights];
+
+    // New en passant target after a double pawn push.
+    if (move.is_double_pawn_push) {
+        int en_passant_sq = (active_player == PlayerColor::White) ? to_sq - 8 : to_sq + 8;
+        hash ^= zobrist_en_passant_keys[ChessBitboardUtils::square_to_file(en_passant_sq)];
+    }
+
+    return hash;
+}
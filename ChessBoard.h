@@ -124,6 +124,10 @@ struct ChessBoard {
     // Leverages bitboards for efficient attack detection.
     bool is_king_in_check(PlayerColor king_color) const;
 
+    // Returns a bitboard of all pieces (of both colors) attacking 'square_idx', with sliding
+    // attacks computed against 'occupancy' instead of the real board (used for x-rays in SEE).
+    uint64_t attackers_to(int square_idx, uint64_t occupancy) const;
+
     // Helper to get the square index (0-63) of a specific piece type and color.
     // Returns a special value (e.g., 64) if piece is not found.
     int get_piece_square_index(PieceTypeIndex piece_type_idx, PlayerColor piece_color) const;
@@ -131,12 +135,18 @@ struct ChessBoard {
     // Zobrist-related Methods (grouped at the bottom for readability):
     // Initializes the static Zobrist keys (should be called once at program startup).
     static void initialize_zobrist_keys();
+    // The seed of the Zobrist key generator. Keys, and so every stored hash, depend only on it
+    // (saved TT files record it to reject tables made with different keys).
+    static uint64_t zobrist_seed();
     // Calculates the Zobrist hash of the current board state from scratch.
     // Used for initial setup (e.g., in FEN constructor) or for verification.
     uint64_t calculate_zobrist_hash_from_scratch() const;
     // Helper to toggle a piece's hash contribution when it moves or is captured.
     // This is used for incremental hash updates.
     void toggle_zobrist_piece(PieceTypeIndex piece_type_idx, PlayerColor piece_color, int square_idx);
+    // Computes the Zobrist hash the board would have after 'move', without applying it.
+    // Mirrors the incremental hash updates of apply_move (used to probe the TT for children).
+    uint64_t hash_after_move(const Move& move) const;
 };
 
 #endif // CHESS_BOARD_H
@@ -3,6 +3,7 @@
 
 #include <cstdint> // For uint8_t, uint64_t
 #include <array>   // For std::array for FILE_MASKS_ARRAY
+#include <cstddef> // For size_t
 
 // ============================================================================
 // --- Customizable AI & Evaluation Constants (Tuning Parameters) ---
@@ -10,7 +11,110 @@
 
 // Define the search depth for the Alpha-Beta pruning algorithm.
 // Higher depth means stronger AI but more computation time.
-constexpr uint64_t AI_SEARCH_DEPTH = 5; 
+constexpr uint64_t AI_SEARCH_DEPTH = 5;
+
+// --- Transposition Table ---
+// Size of the transposition table in megabytes (64-byte buckets of four entries each).
+// The UCI "Hash" option changes it within [TT_MIN_SIZE_MB, TT_MAX_SIZE_MB]. The bucket count
+// is rounded down to a power of two, so sizes that are not powers of two waste some memory.
+constexpr size_t TT_DEFAULT_SIZE_MB = 32;
+constexpr size_t TT_MIN_SIZE_MB     = 1;
+constexpr size_t TT_MAX_SIZE_MB     = 32768;
+// File the "SaveHash" and "LoadHash" buttons use unless the "HashFile" option names another.
+constexpr const char* TT_DEFAULT_FILE = "carolyna.tt";
+
+// --- Evaluation Cache ---
+// Number of entries (a power of two) in each search thread's direct-mapped cache of static
+// evaluations. 16 bytes per entry, so the default takes 1 MB per thread.
+constexpr size_t EVAL_CACHE_ENTRIES = 1 << 16;
+
+// --- Late Move Reductions (LMR) ---
+// Quiet moves that come late in the move ordering are first searched at a reduced depth.
+// The base reduction is LMR_BASE + ln(depth) * ln(move_number) / LMR_DIVISOR.
+constexpr double LMR_BASE    = 0.75;
+constexpr double LMR_DIVISOR = 2.25;
+// Reductions are only applied when at least this much depth remains.
+constexpr int LMR_MIN_DEPTH = 3;
+// The first moves in the ordering (TT move, good captures, killers) are never reduced.
+constexpr int LMR_MIN_MOVE_NUMBER = 3;
+// History score worth one ply of reduction (good history reduces less, bad history more).
+constexpr int LMR_HISTORY_DIVISOR = 8000;
+
+// --- Frontier Pruning (based on the static evaluation of the node) ---
+// Reverse futility pruning: a non-PV node whose static eval beats beta by
+// REVERSE_FUTILITY_MARGIN per remaining ply is cut off without searching.
+constexpr int REVERSE_FUTILITY_MAX_DEPTH = 3;
+constexpr int REVERSE_FUTILITY_MARGIN    = 120;
+// Futility pruning: when the static eval plus the margin for the remaining depth
+// cannot reach alpha, quiet moves that do not give check are skipped.
+constexpr int FUTILITY_MAX_DEPTH         = 3;
+constexpr int FUTILITY_MARGIN_BASE       = 100;
+constexpr int FUTILITY_MARGIN_PER_DEPTH  = 120;
+// Razoring: when the static eval is this far below alpha per remaining ply,
+// the node is resolved by quiescence search instead.
+constexpr int RAZORING_MAX_DEPTH         = 2;
+constexpr int RAZORING_MARGIN            = 300;
+
+// --- Quiet Move Pruning (non-PV nodes, not in check) ---
+// Late move pruning: once LATE_MOVE_PRUNING_BASE + depth * depth quiet moves have been
+// searched without a cutoff, the remaining quiet moves are skipped.
+constexpr int LATE_MOVE_PRUNING_MAX_DEPTH = 3;
+constexpr int LATE_MOVE_PRUNING_BASE      = 3;
+// History pruning: quiet moves whose history score is below
+// -HISTORY_PRUNING_THRESHOLD * depth are skipped at low depth.
+constexpr int HISTORY_PRUNING_MAX_DEPTH   = 2;
+constexpr int HISTORY_PRUNING_THRESHOLD   = 3000;
+
+// --- History Heuristics (move ordering) ---
+// Every history entry stays within [-HISTORY_MAX, HISTORY_MAX]: an update of size b moves
+// the entry by b - entry * |b| / HISTORY_MAX, so entries near the bound barely move.
+constexpr int HISTORY_MAX = 16384;
+// A cutoff at depth d is worth min(HISTORY_BONUS_SCALE * d * d, HISTORY_BONUS_MAX).
+constexpr int HISTORY_BONUS_SCALE = 32;
+constexpr int HISTORY_BONUS_MAX   = 2048;
+// Capture history is divided by this before it is added to the MVV-LVA order of a capture.
+constexpr int CAPTURE_HISTORY_ORDER_DIVISOR = 16;
+
+// --- Quiescence Search Pruning (not in check) ---
+// Delta pruning: a capture is skipped when the stand-pat score plus the value of the captured
+// piece (and of the promotion) plus QSEARCH_DELTA_MARGIN still cannot reach alpha.
+// Captures that lose material according to SEE are skipped as well.
+constexpr int QSEARCH_DELTA_MARGIN = 200;
+// Quiet moves that give check (and do not lose material by SEE) are also searched on the
+// first quiescence ply. In check, quiescence search tries every evasion and never stands pat.
+constexpr bool QSEARCH_QUIET_CHECKS = true;
+
+// --- Search Extensions ---
+// Moves that give check are searched one ply deeper.
+// Singular extensions: a TT move that beats every alternative by
+// SINGULAR_MARGIN_PER_DEPTH * depth in an excluded-move search is searched one ply deeper.
+constexpr int SINGULAR_EXTENSION_MIN_DEPTH = 4;
+constexpr int SINGULAR_MARGIN_PER_DEPTH    = 2;
+// Extensions stop once a line is this many times longer than the root depth.
+constexpr int EXTENSION_PLY_LIMIT_FACTOR   = 2;
+
+// --- ProbCut ---
+// At cut nodes with enough depth, a capture whose reduced-depth search beats
+// beta + PROBCUT_MARGIN is taken as proof that the full-depth search fails high too.
+constexpr int PROBCUT_MIN_DEPTH       = 5;
+constexpr int PROBCUT_DEPTH_REDUCTION = 4;
+constexpr int PROBCUT_MARGIN          = 200;
+
+// --- Enhanced Transposition Cutoffs (ETC) ---
+// Before searching a non-PV node with at least ETC_MIN_DEPTH remaining, the TT entries of the
+// children of its first ETC_MAX_MOVES moves are probed. A child already known to fail low
+// deeply enough proves the cutoff here without a search.
+constexpr bool ENABLE_ETC   = true;
+constexpr int ETC_MIN_DEPTH = 3;
+constexpr int ETC_MAX_MOVES = 8;
+
+// --- Internal Iterative Deepening (IID) ---
+// A PV node with no TT move to search first runs a search IID_DEPTH_REDUCTION plies
+// shallower when at least IID_MIN_DEPTH remains, and uses its best move as the TT move.
+// Iterative deepening normally leaves a TT move at PV nodes; IID covers the ones whose entry
+// was never stored or has since been replaced.
+constexpr int IID_MIN_DEPTH       = 4;
+constexpr int IID_DEPTH_REDUCTION = 2;
 
 // --- Piece Values (can be adjusted to emphasize/de-emphasize pieces) ---
 // These values represent the relative strength of each piece.
@@ -65,9 +169,10 @@ constexpr int CONNECTED_PAWN_BONUS = 15;
 // --- Non-Customizable / Fixed Constants (System and Utility) ---
 // ============================================================================
 
-// Optional: Number of CPU cores/threads to use for parallel search (e.g., for root moves).
+// Default number of search threads (Lazy SMP), changed with the UCI "Threads" option.
 // This is a system-level configuration, not an AI tuning parameter.
 const uint8_t NUMBER_OF_CORES_USED = 4;
+constexpr size_t MAX_SEARCH_THREADS = 256;
 
 // Define the different types of AI algorithms your engine can use.
 // This is an enum for strategic choice, not a numerical tuning knob.
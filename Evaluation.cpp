@@ -2,8 +2,40 @@
 #include "Constants.h" // To get all evaluation constants
 #include "ChessAI.h"   // To get PSTs from ChessAI
 
+#include <algorithm>
+#include <limits>
+
 namespace Evaluation {
 
+	// --- Bounds of the evaluation terms, used by lazy evaluation ---
+	// Most squares a piece of each type can reach (pawns: two captures and two pushes).
+	constexpr int MAX_PAWN_MOBILITY   = 4;
+	constexpr int MAX_KNIGHT_MOBILITY = 8;
+	constexpr int MAX_BISHOP_MOBILITY = 13;
+	constexpr int MAX_ROOK_MOBILITY   = 14;
+	constexpr int MAX_QUEEN_MOBILITY  = 27;
+	constexpr int MAX_KING_MOBILITY   = 8;
+	// Largest bonus and penalty a single pawn can receive from the pawn structure terms
+	// (a passed pawn on its 7th rank that is also connected; an isolated, doubled pawn).
+	constexpr int MAX_PAWN_STRUCTURE_BONUS   = PASSED_PAWN_BASE_BONUS + 5 * PASSED_PAWN_RANK_BONUS_FACTOR + CONNECTED_PAWN_BONUS;
+	constexpr int MAX_PAWN_STRUCTURE_PENALTY = ISOLATED_PAWN_PENALTY + DOUBLED_PAWN_PENALTY;
+	// Largest bonus and penalty of one side's king safety: one castling bonus; three shield
+	// pawns both missing and advanced, and three open files around the king.
+	constexpr int MAX_KING_SAFETY_BONUS   = std::max(CASTLING_BONUS_KINGSIDE, CASTLING_BONUS_QUEENSIDE);
+	constexpr int MAX_KING_SAFETY_PENALTY = 3 * (PAWN_SHIELD_MISSING_PAWN_PENALTY + PAWN_SHIELD_ADVANCED_PAWN_PENALTY) +
+	                                        3 * std::max(OPEN_FILE_FULL_OPEN_PENALTY, OPEN_FILE_SEMI_OPEN_PENALTY);
+
+	// Largest mobility bonus the given pieces (plus a king) can earn.
+	static int max_mobility_bonus(uint64_t pawns, uint64_t knights, uint64_t bishops, uint64_t rooks, uint64_t queens) {
+		int squares = ChessBitboardUtils::count_set_bits(pawns) * MAX_PAWN_MOBILITY +
+		              ChessBitboardUtils::count_set_bits(knights) * MAX_KNIGHT_MOBILITY +
+		              ChessBitboardUtils::count_set_bits(bishops) * MAX_BISHOP_MOBILITY +
+		              ChessBitboardUtils::count_set_bits(rooks) * MAX_ROOK_MOBILITY +
+		              ChessBitboardUtils::count_set_bits(queens) * MAX_QUEEN_MOBILITY +
+		              MAX_KING_MOBILITY;
+		return squares * MOBILITY_BONUS_PER_SQUARE;
+	}
+
 	/**
 	 * @brief Calculates the pawn shield penalty for a given king's color.
 	 *
@@ -194,7 +226,52 @@ namespace Evaluation {
 	 * @return An integer representing the static evaluation score of the board.
 	 */
 	int evaluate(const ChessBoard& board) {
+		bool is_exact = true;
+		return evaluate(board, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), is_exact);
+	}
+
+	/**
+	 * @brief Evaluates the board like evaluate(board), but stops early outside a window.
+	 *
+	 * The phases run in the same order. Before each of phases 2 to 4, the score so far plus the
+	 * largest possible contribution of the phases still to come is compared with the window:
+	 * if even that cannot reach alpha (or even the smallest cannot drop below beta), the
+	 * remaining phases, mobility above all, are skipped.
+	 *
+	 * @param board The ChessBoard object representing the current game state.
+	 * @param alpha Lower end of the window, from White's point of view.
+	 * @param beta Upper end of the window, from White's point of view.
+	 * @param is_exact Set to true if the full score is returned, false if a bound is.
+	 * @return The score, or a bound outside the window when is_exact is false.
+	 */
+	int evaluate(const ChessBoard& board, int alpha, int beta, bool& is_exact) {
 		int score = 0;
+		is_exact = false;
+
+		// How far each remaining phase can still move the score up (for White) or down.
+		int pawn_structure_upper = ChessBitboardUtils::count_set_bits(board.white_pawns) * MAX_PAWN_STRUCTURE_BONUS +
+		                           ChessBitboardUtils::count_set_bits(board.black_pawns) * MAX_PAWN_STRUCTURE_PENALTY;
+		int pawn_structure_lower = ChessBitboardUtils::count_set_bits(board.black_pawns) * MAX_PAWN_STRUCTURE_BONUS +
+		                           ChessBitboardUtils::count_set_bits(board.white_pawns) * MAX_PAWN_STRUCTURE_PENALTY;
+		int king_safety_bound = MAX_KING_SAFETY_BONUS + MAX_KING_SAFETY_PENALTY;
+		int mobility_upper = max_mobility_bonus(board.white_pawns, board.white_knights, board.white_bishops,
+		                                        board.white_rooks, board.white_queens);
+		int mobility_lower = max_mobility_bonus(board.black_pawns, board.black_knights, board.black_bishops,
+		                                        board.black_rooks, board.black_queens);
+
+		// Returns true (and the bound in 'result') when the remaining phases cannot bring the score into the window.
+		auto outside_window = [&](int remaining_upper, int remaining_lower, int& result) {
+			if (score + remaining_upper <= alpha) {
+				result = score + remaining_upper;
+				return true;
+			}
+			if (score - remaining_lower >= beta) {
+				result = score - remaining_lower;
+				return true;
+			}
+			return false;
+		};
+		int lazy_result = 0;
 
 		// Phase 1: Material and Piece-Square Table (PST) scores
 		// Iterates through all 64 squares of the board.
@@ -216,6 +293,11 @@ namespace Evaluation {
 			else if (ChessBitboardUtils::test_bit(board.black_king, i)) score -= (KING_VALUE + ChessAI::KING_PST[63 - i]);
 		}
 
+		if (outside_window(pawn_structure_upper + king_safety_bound + mobility_upper,
+		                   pawn_structure_lower + king_safety_bound + mobility_lower, lazy_result)) {
+			return lazy_result;
+		}
+
 		// Phase 2: Pawn Structure Evaluation (Isolated, Doubled, Passed, and Connected Pawns)
 		int white_pawn_structure_score = 0;
 		int black_pawn_structure_score = 0;
@@ -359,6 +441,10 @@ namespace Evaluation {
 		score += white_pawn_structure_score;
 		score -= black_pawn_structure_score;
 
+		if (outside_window(king_safety_bound + mobility_upper, king_safety_bound + mobility_lower, lazy_result)) {
+			return lazy_result;
+		}
+
 		// Phase 3: King Safety Evaluation
 		int white_king_safety_score = 0;
 		int black_king_safety_score = 0;
@@ -404,6 +490,10 @@ namespace Evaluation {
 		score += white_king_safety_score;
 		score -= black_king_safety_score;
 
+		if (outside_window(mobility_upper, mobility_lower, lazy_result)) {
+			return lazy_result;
+		}
+
 		// Phase 4: Piece Mobility (Bonus for controlled squares)
 		int white_mobility_score = 0;
 		int black_mobility_score = 0;
@@ -565,7 +655,7 @@ namespace Evaluation {
 		score += white_mobility_score * MOBILITY_BONUS_PER_SQUARE;
 		score -= black_mobility_score * MOBILITY_BONUS_PER_SQUARE;
 
-
+		is_exact = true;
 		return score;
 	}
 
@@ -18,6 +18,13 @@ namespace Evaluation {
 
     int evaluate(const ChessBoard& board);
 
+    // Lazy evaluation against a window given from White's point of view. The cheap terms are
+    // computed first; as soon as the largest possible contribution of the remaining terms can
+    // no longer bring the score inside (alpha, beta), the bound reached so far is returned:
+    // an upper bound when it is <= alpha, a lower bound when it is >= beta. is_exact is set
+    // when the score was computed in full.
+    int evaluate(const ChessBoard& board, int alpha, int beta, bool& is_exact);
+
 } // namespace Evaluation
 
 #endif // EVALUATION_H
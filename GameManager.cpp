@@ -4,13 +4,21 @@
 #include <sstream>
 #include <random>
 #include <algorithm>
+#include <chrono>
+#include <new>
 
 
 GameManager::GameManager()
 	: board(),
 	  chess_ai(),
-	  uci_handler() {
+	  uci_handler(),
+	  thread_pool(NUMBER_OF_CORES_USED),
+	  hash_size_mb(TT_DEFAULT_SIZE_MB),
+	  shared_hash_name(),
+	  hash_file_name(TT_DEFAULT_FILE) {
 	ChessBitboardUtils::initialize_attack_tables();
+	chess_ai.uci_output = &uci_handler;
+	chess_ai.thread_pool = &thread_pool;
 }
 
 void GameManager::run() {
@@ -26,10 +34,14 @@ void GameManager::run() {
 			handleIsReadyCommand();
 		} else if (command == "ucinewgame") {
 			handleUciNewGameCommand();
+		} else if (command == "setoption") {
+			handleSetOptionCommand(line);
 		} else if (command == "position") {
 			handlePositionCommand(line);
 		} else if (command == "go") {
 			handleGoCommand();
+		} else if (command == "perft") {
+			handlePerftCommand(line);
 		} else if (command == "quit") {
 			break;
 		} else if (command == "d") {
@@ -49,6 +61,92 @@ void GameManager::handleIsReadyCommand() {
 
 void GameManager::handleUciNewGameCommand() {
 	board.reset_to_start_position();
+	// Results from the previous game would only mislead the next one. A shared table is
+	// left alone: the other processes are still using it.
+	if (!chess_ai.transposition_table->is_shared()) {
+		chess_ai.transposition_table->clear(&thread_pool);
+	}
+}
+
+// (Re)allocates the TT for the current Hash and SharedHash options. Without a shared-memory
+// name, or when the segment cannot be used, the table is private to this process. If the memory
+// cannot be allocated, the current table stays in use and hash_size_mb is set to its size.
+void GameManager::allocateTranspositionTable() {
+	if (!shared_hash_name.empty()) {
+		if (chess_ai.transposition_table->attach_shared(shared_hash_name, hash_size_mb)) {
+			return;
+		}
+		std::cerr << "DEBUG: Could not attach shared hash '" << shared_hash_name
+		          << "', using a private table instead." << std::endl;
+	}
+	try {
+		chess_ai.transposition_table->resize(hash_size_mb, &thread_pool);
+	} catch (const std::bad_alloc&) {
+		// resize keeps the old table when the new one cannot be allocated; report the size in use.
+		size_t kept_mb = chess_ai.transposition_table->size_in_megabytes();
+		uci_handler.sendInfo("Could not allocate " + std::to_string(hash_size_mb) + " MB for the hash, keeping " +
+		                     std::to_string(kept_mb) + " MB");
+		hash_size_mb = kept_mb;
+	}
+}
+
+// Handles "setoption name <id> [value <x>]". Option names may contain spaces.
+void GameManager::handleSetOptionCommand(const std::string& command_line) {
+	std::stringstream ss(command_line);
+	std::string token;
+	std::string name;
+	std::string value;
+
+	ss >> token; // "setoption"
+	ss >> token; // "name"
+	while (ss >> token && token != "value") {
+		name += (name.empty() ? "" : " ") + token;
+	}
+	std::getline(ss >> std::ws, value);
+
+	if (name == "Hash") {
+		try {
+			long long megabytes = std::stoll(value);
+			hash_size_mb = static_cast<size_t>(std::clamp<long long>(megabytes, TT_MIN_SIZE_MB, TT_MAX_SIZE_MB));
+			allocateTranspositionTable();
+		} catch (const std::exception& e) {
+			std::cerr << "DEBUG: Invalid Hash value in 'setoption' command: " << value << std::endl;
+		}
+	} else if (name == "Threads") {
+		try {
+			long long threads = std::stoll(value);
+			chess_ai.thread_count = static_cast<size_t>(std::clamp<long long>(threads, 1, MAX_SEARCH_THREADS));
+			thread_pool.resize(chess_ai.thread_count);
+		} catch (const std::exception& e) {
+			std::cerr << "DEBUG: Invalid Threads value in 'setoption' command: " << value << std::endl;
+		}
+	} else if (name == "SharedHash") {
+		// The name of a POSIX shared-memory segment; engine processes given the same name
+		// share one TT. "<empty>" (or no value) switches back to a private table.
+		shared_hash_name = (value == "<empty>") ? "" : value;
+		allocateTranspositionTable();
+	} else if (name == "HashFile") {
+		hash_file_name = value;
+	} else if (name == "SaveHash") {
+		// Snapshots of a long analysis, so that a restarted engine can resume from them.
+		if (chess_ai.transposition_table->save_to_file(hash_file_name)) {
+			uci_handler.sendInfo("Hash saved to " + hash_file_name);
+		} else {
+			uci_handler.sendInfo("Could not save hash to " + hash_file_name);
+		}
+	} else if (name == "LoadHash") {
+		if (chess_ai.transposition_table->is_shared()) {
+			uci_handler.sendInfo("Cannot load hash into the shared table " + shared_hash_name);
+		} else if (chess_ai.transposition_table->load_from_file(hash_file_name)) {
+			// The table takes over the saved size, which the Hash option now reflects.
+			hash_size_mb = chess_ai.transposition_table->size_in_megabytes();
+			uci_handler.sendInfo("Hash loaded from " + hash_file_name + " (" + std::to_string(hash_size_mb) + " MB)");
+		} else {
+			uci_handler.sendInfo("Could not load hash from " + hash_file_name);
+		}
+	} else {
+		std::cerr << "DEBUG: Unknown option in 'setoption' command: " << name << std::endl;
+	}
 }
 
 void GameManager::handlePositionCommand(const std::string& command_line) {
@@ -115,6 +213,65 @@ void GameManager::handleGoCommand() {
 	if (best_move.piece_moved_type_idx == PieceTypeIndex::NONE) {
 		this->uci_handler.sendBestMove("(none)");
 	} else {
-		this->uci_handler.sendBestMove(ChessBitboardUtils::move_to_string(best_move));
+		std::string ponder_string;
+		if (chess_ai.ponder_move.piece_moved_type_idx != PieceTypeIndex::NONE) {
+			ponder_string = ChessBitboardUtils::move_to_string(chess_ai.ponder_move);
+		}
+		this->uci_handler.sendBestMove(ChessBitboardUtils::move_to_string(best_move), ponder_string);
+	}
+}
+
+// Counts the leaf nodes of the legal move tree below the position, 'depth' plies deep.
+static unsigned long long perft(ChessBoard& board, MoveGenerator& move_gen, int depth) {
+	if (depth == 0) {
+		return 1;
+	}
+	std::vector<Move> legal_moves = move_gen.generate_legal_moves(board);
+	if (depth == 1) {
+		return legal_moves.size();
+	}
+	unsigned long long nodes = 0;
+	for (const auto& move : legal_moves) {
+		StateInfo info_for_undo;
+		board.apply_move(move, info_for_undo);
+		nodes += perft(board, move_gen, depth - 1);
+		board.undo_move(move, info_for_undo);
+	}
+	return nodes;
+}
+
+// Handles "perft <depth>": every root move's subtree is counted as its own pool task.
+void GameManager::handlePerftCommand(const std::string& command_line) {
+	std::stringstream ss(command_line);
+	std::string token;
+	int depth = 0;
+	ss >> token >> depth;
+	if (depth < 1) {
+		std::cerr << "DEBUG: Invalid depth in 'perft' command: " << command_line << std::endl;
+		return;
+	}
+
+	auto start_time = std::chrono::high_resolution_clock::now();
+
+	MoveGenerator move_gen;
+	std::vector<Move> root_moves = move_gen.generate_legal_moves(board);
+	std::vector<unsigned long long> subtree_nodes(root_moves.size(), 0);
+	for (size_t i = 0; i < root_moves.size(); ++i) {
+		thread_pool.submit([&subtree_nodes, &root_moves, i, depth, task_board = board]() mutable {
+			MoveGenerator task_move_gen;
+			StateInfo info_for_undo;
+			task_board.apply_move(root_moves[i], info_for_undo);
+			subtree_nodes[i] = perft(task_board, task_move_gen, depth - 1);
+		});
+	}
+	thread_pool.wait();
+
+	unsigned long long total_nodes = 0;
+	for (size_t i = 0; i < root_moves.size(); ++i) {
+		uci_handler.sendPerftMove(ChessBitboardUtils::move_to_string(root_moves[i]), subtree_nodes[i]);
+		total_nodes += subtree_nodes[i];
 	}
+	long long duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::high_resolution_clock::now() - start_time).count();
+	uci_handler.sendPerftTotal(total_nodes, duration_ms);
 }
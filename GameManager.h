@@ -9,6 +9,7 @@
 #include "MoveGenerator.h"
 #include "ChessAI.h"
 #include "UciHandler.h"
+#include "ThreadPool.h"
 
 class GameManager {
 public:
@@ -20,12 +21,21 @@ private:
     ChessBoard board;
     ChessAI chess_ai;
     UciHandler uci_handler; 
+    // Started once and shared by the search helpers, TT clearing and perft.
+    ThreadPool thread_pool;
+    // Values of the "Hash", "SharedHash" and "HashFile" options.
+    size_t hash_size_mb;
+    std::string shared_hash_name;
+    std::string hash_file_name;
 
     void handleUciCommand();
     void handleIsReadyCommand();
     void handleUciNewGameCommand();
+    void handleSetOptionCommand(const std::string& command_line);
+    void allocateTranspositionTable();
     void handlePositionCommand(const std::string& command_line);
     void handleGoCommand();
+    void handlePerftCommand(const std::string& command_line);
 };
 
 #endif // GAME_MANAGER_H
@@ -322,9 +322,28 @@ void MoveGenerator::generate_king_moves(const ChessBoard& board, int square_idx,
 
 
 std::vector<Move> MoveGenerator::generate_legal_moves(ChessBoard& board) {
+    std::vector<Move> pseudo_legal_moves = generate_pseudo_legal_moves(board);
+    std::vector<Move> legal_moves;
+    PlayerColor current_player = board.active_player;
+
+    for (const auto& move : pseudo_legal_moves) {
+        StateInfo info_for_undo;
+        
+        board.apply_move(move, info_for_undo);
+
+        if (!board.is_king_in_check(current_player)) {
+            legal_moves.push_back(move);
+        }
+        
+        board.undo_move(move, info_for_undo);
+    }
+    
+    return legal_moves;
+}
+
+std::vector<Move> MoveGenerator::generate_pseudo_legal_moves(const ChessBoard& board) {
     std::vector<Move> pseudo_legal_moves;
     pseudo_legal_moves.reserve(MAX_MOVES); 
-    std::vector<Move> legal_moves;
     
     PlayerColor current_player = board.active_player;
     uint64_t player_pieces_bb = (current_player == PlayerColor::White) ? board.white_occupied_squares : board.black_occupied_squares;
@@ -362,17 +381,5 @@ std::vector<Move> MoveGenerator::generate_legal_moves(ChessBoard& board) {
         }
     }
 
-    for (const auto& move : pseudo_legal_moves) {
-        StateInfo info_for_undo;
-        
-        board.apply_move(move, info_for_undo);
-
-        if (!board.is_king_in_check(current_player)) {
-            legal_moves.push_back(move);
-        }
-        
-        board.undo_move(move, info_for_undo);
-    }
-    
-    return legal_moves;
+    return pseudo_legal_moves;
 }
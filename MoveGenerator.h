@@ -20,6 +20,11 @@ struct MoveGenerator {
     // apply and undo moves in-place for legality checking.
     std::vector<Move> generate_legal_moves(ChessBoard& board);
 
+    // Generates all pseudo-legal moves for the active player: moves that follow the piece
+    // movement rules but may leave the mover's own king in check. The search uses these and
+    // checks legality lazily, right after making each move.
+    std::vector<Move> generate_pseudo_legal_moves(const ChessBoard& board);
+
     // --- Helper functions for generating pseudo-legal moves for individual piece types ---
     // These functions take the current board, the square the piece is on,
     // and a reference to the vector where generated moves will be added.
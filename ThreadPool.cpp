@@ -0,0 +1,113 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t thread_count) :
+    next_queue(0),
+    queued_tasks(0),
+    unfinished_tasks(0),
+    stopping(false) {
+    start(thread_count);
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+}
+
+void ThreadPool::resize(size_t thread_count) {
+    stop();
+    start(thread_count);
+}
+
+void ThreadPool::start(size_t thread_count) {
+    thread_count = std::max<size_t>(thread_count, 1);
+    stopping = false;
+    for (size_t i = 0; i < thread_count; ++i) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+void ThreadPool::stop() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    queues.clear();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    WorkQueue& queue = *queues[next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_mutex);
+        queued_tasks++;
+        unfinished_tasks++;
+    }
+    work_available.notify_one();
+}
+
+void ThreadPool::wait() {
+    std::unique_lock<std::mutex> lock(state_mutex);
+    all_done.wait(lock, [this]() { return unfinished_tasks == 0; });
+}
+
+bool ThreadPool::take_task(size_t index, std::function<void()>& task) {
+    // Our own queue first, oldest task first.
+    {
+        WorkQueue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    // Then steal the newest task of another worker, which is the one its owner would reach last.
+    for (size_t offset = 1; offset < queues.size(); ++offset) {
+        WorkQueue& victim = *queues[(index + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(state_mutex);
+            work_available.wait(lock, [this]() { return stopping || queued_tasks > 0; });
+            if (queued_tasks == 0) {
+                return; // Stopping, and nothing is left to do.
+            }
+            // Claiming a task here guarantees that one is waiting in some queue for us.
+            queued_tasks--;
+        }
+
+        std::function<void()> task;
+        while (!take_task(index, task)) {
+            std::this_thread::yield();
+        }
+        task();
+
+        std::lock_guard<std::mutex> lock(state_mutex);
+        if (--unfinished_tasks == 0) {
+            all_done.notify_all();
+        }
+    }
+}
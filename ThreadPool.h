@@ -0,0 +1,60 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that live for the whole session, so starting a search,
+// clearing the TT or running perft never pays for thread creation.
+// Every worker owns a task queue. Tasks are dealt out round-robin; a worker takes from the
+// front of its own queue and, once that is empty, steals from the back of the others', so
+// uneven tasks (perft subtrees, say) still keep every worker busy.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t thread_count);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Replaces the workers with thread_count new ones. Must not be called while tasks are running.
+    void resize(size_t thread_count);
+    size_t size() const { return workers.size(); }
+
+    // Queues a task to run on one of the workers.
+    void submit(std::function<void()> task);
+    // Blocks until every task submitted so far has finished.
+    void wait();
+
+private:
+    // Padded to a cache line each, so workers locking their own queue do not slow down each other.
+    struct alignas(64) WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void start(size_t thread_count);
+    void stop();
+    void worker_loop(size_t index);
+    bool take_task(size_t index, std::function<void()>& task);
+
+    std::vector<std::thread> workers;
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::atomic<size_t> next_queue;
+
+    // Guards the counters below. Workers sleep on work_available, wait() on all_done.
+    std::mutex state_mutex;
+    std::condition_variable work_available;
+    std::condition_variable all_done;
+    size_t queued_tasks;     // Submitted but not yet taken by a worker.
+    size_t unfinished_tasks; // Submitted but not yet finished.
+    bool stopping;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,403 @@
+#include "TranspositionTable.h"
+#include "ChessBitboardUtils.h"
+#include "ThreadPool.h"
+#include "ChessBoard.h"
+#include "Constants.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TT_HAS_POSIX_SHARED_MEMORY 1
+#include <fcntl.h>    // For O_CREAT, O_RDWR
+#include <sys/mman.h> // For madvise (transparent huge pages), shm_open and mmap
+#include <sys/stat.h> // For fstat
+#include <unistd.h>   // For ftruncate, close, usleep
+#include <cerrno>
+
+// How long attach_shared waits for the creator of a segment to size it: 200 x 10 ms.
+static constexpr int SHARED_SIZE_WAIT_ATTEMPTS = 200;
+static constexpr useconds_t SHARED_SIZE_WAIT_MICROSECONDS = 10000;
+#endif
+
+// Entries in shared memory are updated by several processes at once, which is only safe
+// while 64-bit atomics need no lock (a lock would live in one process's memory only).
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "TT entries need lock-free 64-bit atomics");
+
+// Layout of a saved table: this header, then one TTFileRecord per occupied entry. Empty slots
+// are not written, so a snapshot of a sparsely filled table stays small. Integers are stored in
+// the machine's own byte order; the record size check rejects files from a different layout.
+struct TTFileHeader {
+    char magic[8];          // TT_FILE_MAGIC, the last two characters being the format version.
+    uint64_t zobrist_seed;  // ChessBoard::zobrist_seed() of the engine that saved the table.
+    uint64_t bucket_count;  // Size of the saved table, restored on load.
+    uint64_t entry_count;   // Number of records that follow.
+    uint32_t record_bytes;  // sizeof(TTFileRecord) when saved.
+    uint8_t generation;     // Generation counter when saved, so entry ages stay meaningful.
+};
+
+// An occupied entry: its full key and its packed TTData word.
+struct TTFileRecord {
+    uint64_t key;
+    uint64_t data;
+};
+
+static constexpr char TT_FILE_MAGIC[8] = { 'C', 'R', 'L', 'N', 'T', 'T', '0', '2' };
+
+// Checks that 'header' describes a table this engine can use.
+static bool is_valid_file_header(const TTFileHeader& header) {
+    return std::memcmp(header.magic, TT_FILE_MAGIC, sizeof(TT_FILE_MAGIC)) == 0 &&
+           header.zobrist_seed == ChessBoard::zobrist_seed() &&
+           header.record_bytes == sizeof(TTFileRecord) &&
+           header.bucket_count > 0 && (header.bucket_count & (header.bucket_count - 1)) == 0 &&
+           header.bucket_count <= TT_MAX_SIZE_MB * 1024 * 1024 / sizeof(TTBucket) &&
+           header.entry_count <= header.bucket_count * TT_BUCKET_SIZE;
+}
+
+// The largest power-of-two number of buckets that fits in 'bytes' (at least one).
+static size_t power_of_two_bucket_count(size_t bytes) {
+    size_t max_buckets = std::max<size_t>(1, bytes / sizeof(TTBucket));
+    size_t bucket_count = 1;
+    while (bucket_count * 2 <= max_buckets) {
+        bucket_count *= 2;
+    }
+    return bucket_count;
+}
+
+// Whatever the bound, an entry saved in the current search has age 0, one from the previous
+// search GENERATION_DELTA, also across the wrap-around of the generation counter.
+static_assert(TTData{ 0, 0, 0, 1, 8 | 1 }.relative_age(8) == 0, "current entries must have age 0");
+static_assert(TTData{ 0, 0, 0, 1, 8 | 3 }.relative_age(8) == 0, "current entries must have age 0");
+static_assert(TTData{ 0, 0, 0, 1, 4 | 2 }.relative_age(8) == TranspositionTable::GENERATION_DELTA,
+              "entries from the previous search must have age GENERATION_DELTA");
+static_assert(TTData{ 0, 0, 0, 1, 252 | 1 }.relative_age(0) == TranspositionTable::GENERATION_DELTA,
+              "ages must survive the generation counter wrapping around");
+
+// How valuable an entry is to keep: its depth, minus eight plies for every search it has aged.
+// An empty slot is worth less than any entry, so a bucket fills up before anything is evicted.
+static constexpr int replacement_value(const TTData& data, uint8_t generation) {
+    return data.is_empty() ? -1024 : data.depth8 - data.relative_age(generation) * 2;
+}
+
+static_assert(replacement_value(TTData{ 0, 0, 0, 0, 0 }, 8) < replacement_value(TTData{ 0, 0, 0, 1, 8 | 2 }, 8),
+              "an empty slot must be replaced before a shallow entry of the current search");
+static_assert(replacement_value(TTData{ 0, 0, 0, 0, 0 }, 0) < replacement_value(TTData{ 0, 0, 0, 1, 4 | 2 }, 0),
+              "an empty slot must be replaced before even the oldest entry");
+static_assert(replacement_value(TTData{ 0, 0, 0, 1, 4 | 2 }, 8) < replacement_value(TTData{ 0, 0, 0, 1, 8 | 2 }, 8),
+              "an entry from an earlier search must be replaced before one of the same depth from this search");
+
+uint64_t TTData::pack() const {
+    return static_cast<uint64_t>(move16)
+         | static_cast<uint64_t>(static_cast<uint16_t>(score16)) << 16
+         | static_cast<uint64_t>(static_cast<uint16_t>(eval16)) << 32
+         | static_cast<uint64_t>(depth8) << 48
+         | static_cast<uint64_t>(genbound8) << 56;
+}
+
+TTData TTData::unpack(uint64_t data) {
+    TTData result;
+    result.move16 = static_cast<uint16_t>(data);
+    result.score16 = static_cast<int16_t>(static_cast<uint16_t>(data >> 16));
+    result.eval16 = static_cast<int16_t>(static_cast<uint16_t>(data >> 32));
+    result.depth8 = static_cast<uint8_t>(data >> 48);
+    result.genbound8 = static_cast<uint8_t>(data >> 56);
+    return result;
+}
+
+bool TTEntry::read(uint64_t key, TTData& out) const {
+    uint64_t data_word = data.load(std::memory_order_relaxed);
+    uint64_t key_word = key_xor_data.load(std::memory_order_relaxed);
+    out = TTData::unpack(data_word);
+    return (key_word ^ data_word) == key && !out.is_empty();
+}
+
+void TTEntry::save(uint64_t key, int score, int eval, NodeType bound, int depth, uint16_t move, uint8_t generation) {
+    TTData old_data;
+    bool same_position = read(key, old_data);
+    TTData new_data = old_data;
+
+    // Keep the old best move when this search of the same position did not produce one.
+    if (move != 0 || !same_position) {
+        new_data.move16 = move;
+    }
+
+    // A different position, an exact score, a deep enough result or an entry from an earlier
+    // search is overwritten. A shallow bound never replaces a deep result for the same position.
+    if (!same_position || bound == NodeType::EXACT || depth + 4 > old_data.depth() || old_data.relative_age(generation) != 0) {
+        new_data.score16 = static_cast<int16_t>(score);
+        new_data.eval16 = static_cast<int16_t>(eval);
+        new_data.depth8 = static_cast<uint8_t>(std::clamp(depth + 1, 0, 255));
+        new_data.genbound8 = static_cast<uint8_t>(generation | (static_cast<uint8_t>(bound) + 1));
+    }
+
+    uint64_t data_word = new_data.pack();
+    key_xor_data.store(key ^ data_word, std::memory_order_relaxed);
+    data.store(data_word, std::memory_order_relaxed);
+}
+
+TranspositionTable::TranspositionTable() :
+    buckets(nullptr), bucket_count(0), generation8(0),
+    mapped_base(nullptr), mapped_bytes(0), shared_mapping(false) {
+}
+
+TranspositionTable::~TranspositionTable() {
+    free_buckets();
+}
+
+void TranspositionTable::free_buckets() {
+    if (buckets == nullptr) {
+        return;
+    }
+#ifdef TT_HAS_POSIX_SHARED_MEMORY
+    if (mapped_bytes > 0) {
+        munmap(mapped_base, mapped_bytes);
+        mapped_base = nullptr;
+        mapped_bytes = 0;
+        shared_mapping = false;
+        buckets = nullptr;
+        bucket_count = 0;
+        return;
+    }
+#endif
+#ifdef __linux__
+    std::free(buckets);
+#else
+    ::operator delete(buckets, std::align_val_t(alignof(TTBucket)));
+#endif
+    buckets = nullptr;
+    bucket_count = 0;
+}
+
+void TranspositionTable::resize(size_t megabytes, ThreadPool* pool) {
+    allocate_buckets(power_of_two_bucket_count(megabytes * 1024 * 1024));
+    clear(pool);
+}
+
+void TranspositionTable::allocate_buckets(size_t new_bucket_count) {
+    // The new table is allocated before the old one is released, so when the allocation fails
+    // (std::bad_alloc) the current table is still in place and usable.
+    size_t bytes = new_bucket_count * sizeof(TTBucket);
+#ifdef __linux__
+    // Align to 2 MB and ask for transparent huge pages: a large table then needs far fewer
+    // TLB entries, and almost every probe would otherwise be a TLB miss.
+    constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+    size_t alignment = bytes >= HUGE_PAGE_SIZE ? HUGE_PAGE_SIZE : alignof(TTBucket);
+    size_t allocated_bytes = (bytes + alignment - 1) / alignment * alignment;
+    TTBucket* new_buckets = static_cast<TTBucket*>(std::aligned_alloc(alignment, allocated_bytes));
+    if (new_buckets == nullptr) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    madvise(new_buckets, allocated_bytes, MADV_HUGEPAGE);
+#endif
+#else
+    TTBucket* new_buckets = static_cast<TTBucket*>(::operator new(bytes, std::align_val_t(alignof(TTBucket))));
+#endif
+    free_buckets();
+    buckets = new_buckets;
+    bucket_count = new_bucket_count;
+}
+
+void TranspositionTable::clear(ThreadPool* pool) {
+    // Each worker zeroes its own contiguous slice, which also faults the pages in in parallel.
+    size_t slice_count = std::max<size_t>(1, std::min(pool != nullptr ? pool->size() : 1, bucket_count));
+    size_t slice = bucket_count / slice_count;
+    for (size_t i = 0; i < slice_count; ++i) {
+        size_t start = i * slice;
+        size_t count = (i + 1 == slice_count) ? bucket_count - start : slice;
+        auto zero_slice = [this, start, count]() {
+            std::memset(static_cast<void*>(buckets + start), 0, count * sizeof(TTBucket));
+        };
+        if (pool != nullptr) {
+            pool->submit(zero_slice);
+        } else {
+            zero_slice();
+        }
+    }
+    if (pool != nullptr) {
+        pool->wait();
+    }
+    generation8 = 0;
+}
+
+bool TranspositionTable::attach_shared(const std::string& name, size_t megabytes) {
+#ifdef TT_HAS_POSIX_SHARED_MEMORY
+    std::string segment_name = (!name.empty() && name[0] == '/') ? name : "/" + name;
+    // The process that creates the segment sizes it; the others adopt that size, so every
+    // process maps the same number of buckets and finds each key in the same place. O_EXCL
+    // makes creation atomic: exactly one process sizes the segment, and it is sized only once,
+    // so no mapping can ever end up past the end of a segment another process shrank.
+    size_t segment_bytes = 0;
+    int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd >= 0) {
+        segment_bytes = power_of_two_bucket_count(megabytes * 1024 * 1024) * sizeof(TTBucket);
+        if (ftruncate(fd, static_cast<off_t>(segment_bytes)) != 0) {
+            close(fd);
+            shm_unlink(segment_name.c_str());
+            return false;
+        }
+    } else {
+        if (errno != EEXIST) {
+            return false;
+        }
+        fd = shm_open(segment_name.c_str(), O_RDWR, 0600);
+        if (fd < 0) {
+            return false;
+        }
+        // The creator may not have sized the segment yet; give it a moment.
+        for (int attempt = 0; attempt < SHARED_SIZE_WAIT_ATTEMPTS && segment_bytes < sizeof(TTBucket); ++attempt) {
+            struct stat segment_info;
+            if (fstat(fd, &segment_info) != 0) {
+                break;
+            }
+            segment_bytes = static_cast<size_t>(segment_info.st_size);
+            if (segment_bytes < sizeof(TTBucket)) {
+                usleep(SHARED_SIZE_WAIT_MICROSECONDS);
+            }
+        }
+        if (segment_bytes < sizeof(TTBucket)) {
+            close(fd);
+            return false;
+        }
+    }
+    size_t new_bucket_count = power_of_two_bucket_count(segment_bytes);
+    size_t bytes = new_bucket_count * sizeof(TTBucket);
+
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping keeps the segment alive.
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    // A new segment starts zero-filled (all entries empty); an existing one keeps the
+    // results the other processes have stored, which is the point of sharing it.
+    free_buckets();
+    buckets = static_cast<TTBucket*>(memory);
+    bucket_count = new_bucket_count;
+    mapped_base = memory;
+    mapped_bytes = bytes;
+    shared_mapping = true;
+    generation8 = 0;
+    return true;
+#else
+    (void)name;
+    (void)megabytes;
+    return false;
+#endif
+}
+
+bool TranspositionTable::save_to_file(const std::string& path) const {
+    if (buckets == nullptr) {
+        return false;
+    }
+    std::vector<TTFileRecord> records;
+    for (size_t i = 0; i < bucket_count; ++i) {
+        for (const TTEntry& entry : buckets[i].entries) {
+            uint64_t data_word = entry.data.load(std::memory_order_relaxed);
+            if (!TTData::unpack(data_word).is_empty()) {
+                records.push_back(TTFileRecord{ entry.key_xor_data.load(std::memory_order_relaxed) ^ data_word, data_word });
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    TTFileHeader header = {};
+    std::memcpy(header.magic, TT_FILE_MAGIC, sizeof(TT_FILE_MAGIC));
+    header.zobrist_seed = ChessBoard::zobrist_seed();
+    header.bucket_count = bucket_count;
+    header.entry_count = records.size();
+    header.record_bytes = sizeof(TTFileRecord);
+    header.generation = generation8;
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(TTFileRecord)));
+    return static_cast<bool>(file);
+}
+
+bool TranspositionTable::load_from_file(const std::string& path) {
+    // Other processes keep using a shared segment; replacing it would silently detach us.
+    if (shared_mapping) {
+        return false;
+    }
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    uint64_t file_bytes = static_cast<uint64_t>(file.tellg());
+    TTFileHeader header;
+    if (file_bytes < sizeof(header) || !file.seekg(0) ||
+        !file.read(reinterpret_cast<char*>(&header), sizeof(header)) || !is_valid_file_header(header) ||
+        header.entry_count > (file_bytes - sizeof(header)) / sizeof(TTFileRecord)) {
+        return false;
+    }
+
+    // The records are read and the new table is allocated before the old one is released
+    // (see allocate_buckets), so a truncated file or a failed allocation leaves it as it was.
+    try {
+        std::vector<TTFileRecord> records(header.entry_count);
+        if (!file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(TTFileRecord)))) {
+            return false;
+        }
+        allocate_buckets(header.bucket_count);
+        clear();
+        generation8 = header.generation;
+        // The table has the saved size, so every record fits into its bucket again.
+        for (const TTFileRecord& record : records) {
+            bool found = false;
+            TTData existing;
+            TTEntry* entry = probe(record.key, found, existing);
+            entry->key_xor_data.store(record.key ^ record.data, std::memory_order_relaxed);
+            entry->data.store(record.data, std::memory_order_relaxed);
+        }
+    } catch (const std::bad_alloc&) {
+        return false;
+    }
+    return true;
+}
+
+void TranspositionTable::new_search() {
+    generation8 = static_cast<uint8_t>(generation8 + GENERATION_DELTA);
+}
+
+TTEntry* TranspositionTable::probe(uint64_t key, bool& found, TTData& data) {
+    TTEntry* const entries = bucket_for(key)->entries;
+
+    // Without a match, the entry offered for replacement is the one with the lowest
+    // replacement_value: an empty slot first, otherwise the lowest depth, counting every search
+    // of age as eight plies (relative_age grows by GENERATION_DELTA per search).
+    TTEntry* replace = nullptr;
+    int replace_value = 0;
+    for (int i = 0; i < TT_BUCKET_SIZE; ++i) {
+        TTData entry_data;
+        if (entries[i].read(key, entry_data)) {
+            found = true;
+            data = entry_data;
+            return &entries[i];
+        }
+        int value = replacement_value(entry_data, generation8);
+        if (replace == nullptr || value < replace_value) {
+            replace = &entries[i];
+            replace_value = value;
+        }
+    }
+    found = false;
+    return replace;
+}
+
+uint16_t TranspositionTable::pack_move(const Move& move) {
+    if (move.piece_moved_type_idx == PieceTypeIndex::NONE) {
+        return 0;
+    }
+    int from_sq = ChessBitboardUtils::rank_file_to_square(move.from_square.y, move.from_square.x);
+    int to_sq = ChessBitboardUtils::rank_file_to_square(move.to_square.y, move.to_square.x);
+    // Promotion pieces are KNIGHT (1) to QUEEN (4), so 0 is free to mean "no promotion".
+    int promotion = move.is_promotion ? static_cast<int>(move.promotion_piece_type_idx) : 0;
+    return static_cast<uint16_t>(from_sq | (to_sq << 6) | (promotion << 12));
+}
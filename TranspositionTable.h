@@ -0,0 +1,147 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <string>
+
+#include "Move.h"
+#include "Types.h"
+
+class ThreadPool;
+
+// The contents of a transposition table entry, unpacked from its 64-bit data word.
+// Probes hand out a copy of this, so the search never reads an entry another thread is writing.
+struct TTData {
+    uint16_t move16;    // Best move packed by TranspositionTable::pack_move (0 = none).
+    int16_t score16;    // Score, with mate scores relative to this node.
+    int16_t eval16;     // Static evaluation of the position (side to move).
+    uint8_t depth8;     // Search depth + 1, so that 0 is free to mean "never written".
+    uint8_t genbound8;  // Generation in the top 6 bits, bound (NodeType + 1, 0 = empty) in the low 2.
+
+    int score() const { return score16; }
+    int eval() const { return eval16; }
+    int depth() const { return static_cast<int>(depth8) - 1; }
+    uint16_t move() const { return move16; }
+    constexpr bool is_empty() const { return (genbound8 & 0x3) == 0; }
+    NodeType bound() const { return static_cast<NodeType>((genbound8 & 0x3) - 1); }
+
+    // Age of this entry relative to the given generation: 0 for the current search,
+    // GENERATION_DELTA for the one before, and so on.
+    constexpr uint8_t relative_age(uint8_t generation) const;
+
+    uint64_t pack() const;
+    static TTData unpack(uint64_t data);
+};
+
+// A single transposition table entry: the full Zobrist key XORed with the data word, then the
+// data word itself. Both are written and read with relaxed atomics and no lock. If two threads
+// write the same entry at once, a reader may see the key word of one write and the data of
+// the other; the key check then fails and the torn entry is simply treated as a miss.
+struct TTEntry {
+    std::atomic<uint64_t> key_xor_data;
+    std::atomic<uint64_t> data;
+
+    // Copies the entry into 'out' and returns true if it holds a result for 'key'.
+    bool read(uint64_t key, TTData& out) const;
+
+    // Writes the entry, unless it already holds a more valuable result for the same position.
+    void save(uint64_t key, int score, int eval, NodeType bound, int depth, uint16_t move, uint8_t generation);
+};
+
+// Four entries fill one 64-byte cache line, so probing a bucket costs a single memory access.
+constexpr int TT_BUCKET_SIZE = 4;
+
+struct alignas(64) TTBucket {
+    TTEntry entries[TT_BUCKET_SIZE];
+};
+
+static_assert(sizeof(TTEntry) == 16, "TTEntry must stay two 64-bit words");
+static_assert(sizeof(TTBucket) == 64, "TTBucket must fill exactly one cache line");
+
+// The transposition table: an array of cache-line buckets with depth- and age-preferred replacement.
+// A generation counter is bumped at the start of every search, so entries from earlier
+// searches are the first to be replaced. The bucket count is a power of two, so a key's
+// bucket is found with a mask instead of a 64-bit division.
+class TranspositionTable {
+public:
+    // The bound takes the low 2 bits of genbound8, the generation counter the rest.
+    static constexpr uint8_t GENERATION_DELTA = 4;
+    static constexpr uint8_t GENERATION_MASK = 0xFC;
+    // Added before subtracting so the difference stays positive across a wrap-around. The extra
+    // GENERATION_DELTA - 1 absorbs the bound bits, which must not borrow from the generation.
+    static constexpr int GENERATION_CYCLE = 255 + GENERATION_DELTA;
+
+    TranspositionTable();
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Reallocates the table to the largest power-of-two bucket count that fits in the given
+    // number of megabytes, and clears it. The old contents are lost. Throws std::bad_alloc,
+    // keeping the old table, if the memory cannot be allocated.
+    void resize(size_t megabytes, ThreadPool* pool = nullptr);
+    // Empties every entry. With a pool, every worker clears a slice of the table.
+    void clear(ThreadPool* pool = nullptr);
+    // Backs the table with the named POSIX shared-memory segment, creating it with the given
+    // size if it does not exist yet (an existing segment keeps its size). Engine processes
+    // attached to the same name share one table; the segment outlives them until it is
+    // removed (e.g. from /dev/shm). Returns false, leaving the table as it was, if the
+    // segment cannot be used or the platform has no POSIX shared memory.
+    bool attach_shared(const std::string& name, size_t megabytes);
+    bool is_shared() const { return shared_mapping; }
+
+    // Writes the table to 'path': a small header (format, Zobrist seed, bucket count,
+    // generation) followed by the key and data word of every occupied entry. Returns false on
+    // I/O errors.
+    bool save_to_file(const std::string& path) const;
+    // Replaces the table with one written by save_to_file, taking over its size and re-inserting
+    // every saved entry. Returns false, leaving the table as it was, if the file cannot be read,
+    // is not a TT file, was saved with different Zobrist keys or needs more than TT_MAX_SIZE_MB,
+    // if the memory cannot be allocated, or if the table is shared with other processes.
+    bool load_from_file(const std::string& path);
+    size_t size_in_megabytes() const { return bucket_count * sizeof(TTBucket) / (1024 * 1024); }
+    // Starts a new search generation; called once per search.
+    void new_search();
+    uint8_t generation() const { return generation8; }
+
+    // Looks up 'key'. If it is present, 'found' is set, its contents are copied into 'data' and
+    // its entry is returned. Otherwise the entry returned is the one in the key's bucket that is
+    // least valuable to keep. Either way the returned entry is where results for 'key' are saved.
+    TTEntry* probe(uint64_t key, bool& found, TTData& data);
+
+    // Starts loading the bucket of 'key' into the cache without waiting for it. Called right
+    // after a move is made, so the child's probe finds its bucket already on its way from memory.
+    void prefetch(uint64_t key) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&buckets[key & (bucket_count - 1)]);
+#else
+        (void)key;
+#endif
+    }
+
+    // Packs from, to and promotion piece into 16 bits, enough to pick the move out of the
+    // generated move list again. The search only uses a TT move once it has found it among the
+    // moves generated for the position, so a key collision can never feed it an illegal move.
+    static uint16_t pack_move(const Move& move);
+
+private:
+    TTBucket* bucket_for(uint64_t key) { return &buckets[key & (bucket_count - 1)]; }
+    void allocate_buckets(size_t new_bucket_count);
+    void free_buckets();
+
+    TTBucket* buckets;
+    size_t bucket_count;
+    uint8_t generation8;
+    // Set when the buckets live in a shared-memory mapping instead of allocated memory.
+    void* mapped_base;
+    size_t mapped_bytes;
+    bool shared_mapping;
+};
+
+constexpr uint8_t TTData::relative_age(uint8_t generation) const {
+    return static_cast<uint8_t>((TranspositionTable::GENERATION_CYCLE + generation - genbound8) & TranspositionTable::GENERATION_MASK);
+}
+
+#endif // TRANSPOSITION_TABLE_H
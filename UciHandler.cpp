@@ -1,4 +1,5 @@
 #include "UciHandler.h" // Include the UciHandler header
+#include "Constants.h"  // For the default and limits of the engine options
 // <iostream> and <sstream> are already included in UciHandler.h,
 // so no need to include them again here.
 
@@ -36,8 +37,15 @@ void UciHandler::sendUciIdentity() {
     std::cout << "id name Carolyna" << std::endl;
     // "id author <author name>": Specifies the author's name.
     std::cout << "id author Duy Anh" << std::endl;
-    // Any UCI options would be sent here.
-    // Example: std::cout << "option name Hash type spin default 16 min 1 max 1024" << std::endl;
+    // "option name <id> type <t> ...": Options the GUI may change with "setoption".
+    std::cout << "option name Hash type spin default " << TT_DEFAULT_SIZE_MB
+              << " min " << TT_MIN_SIZE_MB << " max " << TT_MAX_SIZE_MB << std::endl;
+    std::cout << "option name Threads type spin default " << static_cast<int>(NUMBER_OF_CORES_USED)
+              << " min 1 max " << MAX_SEARCH_THREADS << std::endl;
+    std::cout << "option name SharedHash type string default <empty>" << std::endl;
+    std::cout << "option name HashFile type string default " << TT_DEFAULT_FILE << std::endl;
+    std::cout << "option name SaveHash type button" << std::endl;
+    std::cout << "option name LoadHash type button" << std::endl;
 }
 
 /**
@@ -76,3 +84,35 @@ void UciHandler::sendBestMove(const std::string& move_string, const std::string&
 void UciHandler::sendInfo(const std::string& message) {
     std::cout << "info string " << message << std::endl; // Flush the output buffer
 }
+
+/**
+ * @brief Sends the "info" line describing a completed search iteration.
+ * Example: "info depth 5 score cp 20 nodes 12345 nps 250000 time 49 pv e2e4 e7e5".
+ */
+void UciHandler::sendSearchInfo(int depth, const std::string& score_string, unsigned long long nodes,
+                                long long time_ms, long long nps, const std::string& pv_string) {
+    std::cout << "info depth " << depth
+              << " score " << score_string
+              << " nodes " << nodes
+              << " nps " << nps
+              << " time " << time_ms;
+    if (!pv_string.empty()) {
+        std::cout << " pv " << pv_string;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Sends the leaf count below one root move of a "perft" run.
+ * Example: "e2e4: 9771".
+ */
+void UciHandler::sendPerftMove(const std::string& move_string, unsigned long long nodes) {
+    std::cout << move_string << ": " << nodes << std::endl;
+}
+
+/**
+ * @brief Sends the total leaf count and timing of a "perft" run.
+ */
+void UciHandler::sendPerftTotal(unsigned long long nodes, long long time_ms) {
+    std::cout << std::endl << "Nodes searched: " << nodes << " (" << time_ms << " ms)" << std::endl;
+}
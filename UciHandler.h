@@ -71,6 +71,32 @@ public:
      */
     void sendInfo(const std::string& message);
 
+    /**
+     * @brief Sends the "info" line describing a completed search iteration.
+     * @param depth The depth the iteration searched to.
+     * @param score_string The score in UCI form, "cp <x>" or "mate <y>".
+     * @param nodes Nodes searched so far.
+     * @param time_ms Milliseconds elapsed since the search started.
+     * @param nps Nodes per second.
+     * @param pv_string The principal variation as space-separated moves.
+     */
+    void sendSearchInfo(int depth, const std::string& score_string, unsigned long long nodes,
+                        long long time_ms, long long nps, const std::string& pv_string);
+
+    /**
+     * @brief Sends the leaf count below one root move of a "perft" run (not part of UCI).
+     * @param move_string The root move (e.g., "e2e4").
+     * @param nodes Number of leaf nodes below it.
+     */
+    void sendPerftMove(const std::string& move_string, unsigned long long nodes);
+
+    /**
+     * @brief Sends the total leaf count and timing of a "perft" run (not part of UCI).
+     * @param nodes Total number of leaf nodes.
+     * @param time_ms Milliseconds the run took.
+     */
+    void sendPerftTotal(unsigned long long nodes, long long time_ms);
+
 private:
     // No private members or helper methods are strictly necessary for this simple
     // handler, as its main job is direct I/O.